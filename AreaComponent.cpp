@@ -4,6 +4,8 @@
 #include "Component/AreaComponent.h"
 #include "CustomParticleSystemComponent.h"
 #include "Components/AudioComponent.h"
+#include "ProjectileSubsystem.h"
+#include "CombatPerfCounters.h"
 #include "Math/Vector.h"
 
 UAreaComponent::UAreaComponent()
@@ -18,10 +20,40 @@ void UAreaComponent::Init(const FSkillAreaInfo& InAreaInfo)
 		return;
 	}
 
-	CalculatedAreaInfo = InAreaInfo;
+	if (ICombatHitPolicy* HitPolicy = UProjectileSubsystem::GetHitPolicy(GetWorld()))
+	{
+		HitPolicy->OnAreaInit(this, InAreaInfo);
+	}
 
 	CasterState = InAreaInfo.Caster->GetPlayerState<ACustomPlayerState>();
 
+	CalculateAreaInfo(InAreaInfo, CalculatedAreaInfo);
+
+	// Create Collision
+	BuildOverlapInfos(CalculatedAreaInfo, OverlapInfoList);
+
+#if !UE_SERVER
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == false)
+	{
+		// Create Decal
+		CreateDecal(CalculatedAreaInfo);
+
+		// Create Particle
+		CreateParticle(CalculatedAreaInfo);
+
+		// Create Audio
+		CreateSound(CalculatedAreaInfo);
+
+		// Significance
+		RegisterSignificance();
+	}
+#endif
+}
+
+void UAreaComponent::CalculateAreaInfo(const FSkillAreaInfo& InAreaInfo, FSkillAreaInfo& OutCalculatedAreaInfo)
+{
+	OutCalculatedAreaInfo = InAreaInfo;
+
 	FVector SpawnLocation = InAreaInfo.OriginSpawnTransform.GetLocation();
 
 	if (InAreaInfo.AreaCount > 1 || InAreaInfo.bForceRandomArea)
@@ -48,31 +80,20 @@ void UAreaComponent::Init(const FSkillAreaInfo& InAreaInfo)
 		SpawnLocation.X += InRandPointInRadius.X;
 		SpawnLocation.Y += InRandPointInRadius.Y;
 
-		CalculatedAreaInfo.DecalDelay = MyUtility::RandRange(0.f, InAreaInfo.DecalDelay);
+		// 위치와 같은 시드를 써서 같은 Timestamp 면 항상 같은 결과가 나오도록
+		OutCalculatedAreaInfo.DecalDelay = InRandStream.FRandRange(0.f, InAreaInfo.DecalDelay);
 	}
 
 	const float HalfHeight = InAreaInfo.Caster->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	SpawnLocation.Z = InAreaInfo.Caster->GetActorLocation().Z - HalfHeight;
 
-	CalculatedAreaInfo.OriginSpawnTransform.SetLocation(SpawnLocation);
-	CalculatedAreaInfo.OriginSpawnTransform.SetScale3D(FVector::OneVector);
-
-	CalculatedAreaInfo.DecalDelay = FMath::Max(0.f, CalculatedAreaInfo.DecalDelay);
-	CalculatedAreaInfo.DecalLifeTime += CalculatedAreaInfo.DecalLifeTime > 0.f ? CalculatedAreaInfo.DecalDelay : 0.f;
-	CalculatedAreaInfo.CollisionCheckDelay += CalculatedAreaInfo.DecalLifeTime;
-	CalculatedAreaInfo.AreaLifeTime += CalculatedAreaInfo.CollisionCheckDelay;
+	OutCalculatedAreaInfo.OriginSpawnTransform.SetLocation(SpawnLocation);
+	OutCalculatedAreaInfo.OriginSpawnTransform.SetScale3D(FVector::OneVector);
 
-	// Create Decal
-	CreateDecal(CalculatedAreaInfo);
-
-	// Create Collision
-	CreateOverlapInfo(CalculatedAreaInfo);
-
-	// Create Particle
-	CreateParticle(CalculatedAreaInfo);
-
-	// Create Audio
-	CreateSound(CalculatedAreaInfo);
+	OutCalculatedAreaInfo.DecalDelay = FMath::Max(0.f, OutCalculatedAreaInfo.DecalDelay);
+	OutCalculatedAreaInfo.DecalLifeTime += OutCalculatedAreaInfo.DecalLifeTime > 0.f ? OutCalculatedAreaInfo.DecalDelay : 0.f;
+	OutCalculatedAreaInfo.CollisionCheckDelay += OutCalculatedAreaInfo.DecalLifeTime;
+	OutCalculatedAreaInfo.AreaLifeTime += OutCalculatedAreaInfo.CollisionCheckDelay;
 }
 
 void UAreaComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -86,15 +107,18 @@ void UAreaComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FA
 
 	if (CalculatedAreaInfo.DecalLifeTime <= ElapsedTime)
 	{
+#if !UE_SERVER
 		if (IsValid(DecalComponent) == true)
 		{
 			DecalComponent->UnregisterComponent();
 			DecalComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
 			DecalComponent = nullptr;
 		}
+#endif
 	}
 	else
 	{
+#if !UE_SERVER
 		if (CalculatedAreaInfo.DecalDelay <= ElapsedTime)
 		{
 			if (IsValid(DecalComponent) == true && DecalComponent->IsVisible() == false)
@@ -102,39 +126,14 @@ void UAreaComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FA
 				DecalComponent->ToggleVisibility();
 			}
 		}
+#endif
 
 		return;
 	}
 
-	// Particle
-	for (int ParticleIndex = 0; ParticleIndex < ParticleComponents.Num(); ParticleIndex++)
-	{
-		// 루프가 아닐경우, 파티클 이미터의 LifeTime이 완료된경우 불필요한 파티클을 제거
-		if (IsValid(ParticleComponents[ParticleIndex]) && ParticleComponents[ParticleIndex]->bWasCompleted)
-		{
-			ParticleComponents[ParticleIndex]->UnregisterComponent();
-			ParticleComponents[ParticleIndex]->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
-			ParticleComponents[ParticleIndex] = nullptr;
-			ParticleComponents.RemoveAt(ParticleIndex--);
-		}
-	}
-
-	// Sound
-	for (int SoundIndex = 0; SoundIndex < AreaSoundInfos.Num(); SoundIndex++)
-	{
-		if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid() == false ||
-			(AreaSoundInfos[SoundIndex].bWasPlayed == true && AreaSoundInfos[SoundIndex].AudioComponent->IsPlaying() == false))
-		{
-			if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid())
-			{
-				AreaSoundInfos[SoundIndex].AudioComponent->Deactivate();
-				AreaSoundInfos[SoundIndex].AudioComponent->DestroyComponent();
-			}
-			AreaSoundInfos[SoundIndex].AudioComponent.Reset();
-			AreaSoundInfos.RemoveAt(SoundIndex--);
-			continue;
-		}
-	}
+#if !UE_SERVER
+	TickParticleAndSound();
+#endif
 
 	// Collision
 	if (CalculatedAreaInfo.Caster->HasAuthority() && CalculatedAreaInfo.CollisionCheckDelay <= ElapsedTime && ElapsedTime <= CalculatedAreaInfo.AreaLifeTime)
@@ -147,23 +146,34 @@ void UAreaComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 {
 	Super::OnComponentDestroyed(bDestroyingHierarchy);
 
-	for (int SoundIndex = 0; SoundIndex < AreaSoundInfos.Num(); SoundIndex++)
-	{
-		if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid())
-		{
-			AreaSoundInfos[SoundIndex].AudioComponent->Deactivate();
-			AreaSoundInfos[SoundIndex].AudioComponent->DestroyComponent();
-		}
-	}
+#if !UE_SERVER
+	UCombatSignificanceSubsystem* SignificanceSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCombatSignificanceSubsystem>() : nullptr;
+	if (SignificanceSubsystem) SignificanceSubsystem->Unregister(this);
+
+	ReleaseSounds(false);
+#endif
+}
+
+void UAreaComponent::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+#if !UE_SERVER
+	UAreaComponent* This = CastChecked<UAreaComponent>(InThis);
+	Collector.AddReferencedObject(This->DecalComponent, This);
+	Collector.AddReferencedObjects(This->ParticleComponents, This);
+#endif
+
+	Super::AddReferencedObjects(InThis, Collector);
 }
 
 const bool UAreaComponent::IsEnd() const
 {
+#if !UE_SERVER
 	if (ParticleComponents.Num() > 0)
 	{
 		// 재생중인 파티클이 있을 경우
 		return false;
 	}
+#endif
 
 	if (IsValid(CalculatedAreaInfo.Caster) == false || CalculatedAreaInfo.Caster->IsDie() || CalculatedAreaInfo.AreaLifeTime < ElapsedTime)
 	{
@@ -176,27 +186,26 @@ const bool UAreaComponent::IsEnd() const
 
 void UAreaComponent::OnEnd()
 {
+#if !UE_SERVER
 	// Sound
 	ACustomCharacter* Caster = CasterState.IsValid() ? Cast<ACustomCharacter>(CasterState->GetPawn()) : nullptr;
 
 	if (IsValid(Caster) && Caster->IsPlayingAction(CalculatedAreaInfo.ActionName) == false)
 	{
-		for (int SoundIndex = 0; SoundIndex < AreaSoundInfos.Num(); SoundIndex++)
-		{
-			if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid())
-			{
-				AreaSoundInfos[SoundIndex].AudioComponent->Deactivate();
-				AreaSoundInfos[SoundIndex].AudioComponent->DestroyComponent();
-				AreaSoundInfos[SoundIndex].AudioComponent.Reset();
-				AreaSoundInfos.RemoveAt(SoundIndex--);
-			}
-		}
+		ReleaseSounds(true);
 	}
+#endif
 }
 
-void UAreaComponent::CreateOverlapInfo(const FSkillAreaInfo& InAreaInfo)
+void UAreaComponent::InitBridge(const FSkillAreaInfo& InCalculatedAreaInfo)
 {
-	if (IsValid(CalculatedAreaInfo.Caster) == false)
+	CalculatedAreaInfo = InCalculatedAreaInfo;
+	CasterState = IsValid(InCalculatedAreaInfo.Caster) ? InCalculatedAreaInfo.Caster->GetPlayerState<ACustomPlayerState>() : nullptr;
+}
+
+void UAreaComponent::BuildOverlapInfos(const FSkillAreaInfo& InAreaInfo, TArray<FAreaOverlapInfo>& OutOverlapInfos)
+{
+	if (IsValid(InAreaInfo.Caster) == false)
 	{
 		return;
 	}
@@ -207,11 +216,11 @@ void UAreaComponent::CreateOverlapInfo(const FSkillAreaInfo& InAreaInfo)
 		FAreaOverlapInfo NewOverlapInfo;
 
 		NewOverlapInfo.ShapeType = InAreaInfo.CollisionShapeType;
-		NewOverlapInfo.OverlapCollisionTM = CalculatedAreaInfo.CollisionRelativeTM * CalculatedAreaInfo.OriginSpawnTransform;
-		NewOverlapInfo.Params.AddIgnoredActor(CalculatedAreaInfo.Caster);
+		NewOverlapInfo.OverlapCollisionTM = InAreaInfo.CollisionRelativeTM * InAreaInfo.OriginSpawnTransform;
+		NewOverlapInfo.Params.AddIgnoredActor(InAreaInfo.Caster);
 
 		FVector ForwardVector = NewOverlapInfo.OverlapCollisionTM.GetRotation().GetForwardVector();
-		FVector BaseExtent = FVector(CalculatedAreaInfo.BaseUnit, CalculatedAreaInfo.BaseUnit, CalculatedAreaInfo.BaseUnit) * NewOverlapInfo.OverlapCollisionTM.GetScale3D();
+		FVector BaseExtent = FVector(InAreaInfo.BaseUnit, InAreaInfo.BaseUnit, InAreaInfo.BaseUnit) * NewOverlapInfo.OverlapCollisionTM.GetScale3D();
 
 		int PatternOffset = InAreaInfo.PatternOffset;
 
@@ -270,7 +279,7 @@ void UAreaComponent::CreateOverlapInfo(const FSkillAreaInfo& InAreaInfo)
 
 			NewOverlapInfo.PatternDelay = Index == 0 ? 0.f : InAreaInfo.PatternDelayOffset;
 
-			OverlapInfoList.Emplace(NewOverlapInfo);
+			OutOverlapInfos.Emplace(NewOverlapInfo);
 		}
 		else
 		{
@@ -279,6 +288,7 @@ void UAreaComponent::CreateOverlapInfo(const FSkillAreaInfo& InAreaInfo)
 	}
 }
 
+#if !UE_SERVER
 void UAreaComponent::CreateDecal(const FSkillAreaInfo& InAreaInfo)
 {
 	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || IsValid(InAreaInfo.Caster) == false || FMath::IsNearlyZero(InAreaInfo.DecalLifeTime))
@@ -405,8 +415,102 @@ void UAreaComponent::CreateSound(const FSkillAreaInfo& InAreaInfo)
 	}
 }
 
+void UAreaComponent::TickParticleAndSound()
+{
+	// Particle
+	for (int ParticleIndex = 0; ParticleIndex < ParticleComponents.Num(); ParticleIndex++)
+	{
+		// 루프가 아닐경우, 파티클 이미터의 LifeTime이 완료된경우 불필요한 파티클을 제거
+		if (IsValid(ParticleComponents[ParticleIndex]) && ParticleComponents[ParticleIndex]->bWasCompleted)
+		{
+			ParticleComponents[ParticleIndex]->UnregisterComponent();
+			ParticleComponents[ParticleIndex]->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			ParticleComponents[ParticleIndex] = nullptr;
+			ParticleComponents.RemoveAt(ParticleIndex--);
+		}
+	}
+
+	// Sound
+	for (int SoundIndex = 0; SoundIndex < AreaSoundInfos.Num(); SoundIndex++)
+	{
+		if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid() == false ||
+			(AreaSoundInfos[SoundIndex].bWasPlayed == true && AreaSoundInfos[SoundIndex].AudioComponent->IsPlaying() == false))
+		{
+			if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid())
+			{
+				AreaSoundInfos[SoundIndex].AudioComponent->Deactivate();
+				AreaSoundInfos[SoundIndex].AudioComponent->DestroyComponent();
+			}
+			AreaSoundInfos[SoundIndex].AudioComponent.Reset();
+			AreaSoundInfos.RemoveAt(SoundIndex--);
+			continue;
+		}
+	}
+}
+
+void UAreaComponent::ReleaseSounds(const bool bInRemove)
+{
+	for (int SoundIndex = 0; SoundIndex < AreaSoundInfos.Num(); SoundIndex++)
+	{
+		if (AreaSoundInfos[SoundIndex].AudioComponent.IsValid())
+		{
+			AreaSoundInfos[SoundIndex].AudioComponent->Deactivate();
+			AreaSoundInfos[SoundIndex].AudioComponent->DestroyComponent();
+
+			if (bInRemove == true)
+			{
+				AreaSoundInfos[SoundIndex].AudioComponent.Reset();
+				AreaSoundInfos.RemoveAt(SoundIndex--);
+			}
+		}
+	}
+}
+
+void UAreaComponent::RegisterSignificance()
+{
+	UCombatSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCombatSignificanceSubsystem>();
+	if (SignificanceSubsystem == nullptr)
+	{
+		return;
+	}
+
+	FCombatSignificanceDesc Desc;
+	Desc.Location = CalculatedAreaInfo.OriginSpawnTransform.GetLocation();
+	Desc.Instigator = CalculatedAreaInfo.Caster;
+
+	// 로컬 플레이어가 장판 범위 안에 있으면 최우선
+	for (const FAreaOverlapInfo& OverlapInfo : OverlapInfoList)
+	{
+		Desc.ThreatRadius = FMath::Max(Desc.ThreatRadius, OverlapInfo.Extent.GetMax());
+	}
+
+	ApplySignificance(SignificanceSubsystem->Register(this, Desc, FOnCombatSignificanceChanged::CreateUObject(this, &UAreaComponent::ApplySignificance)));
+}
+
+void UAreaComponent::ApplySignificance(const ECombatSignificance InSignificance)
+{
+	// 클라이언트의 장판 틱은 연출만 처리한다.
+	if (GetNetMode() == NM_Client)
+	{
+		SetComponentTickInterval(UCombatSignificanceSubsystem::GetTickInterval(InSignificance));
+	}
+
+	for (UParticleSystemComponent* ParticleComponent : ParticleComponents)
+	{
+		UCombatSignificanceSubsystem::ApplyToParticle(ParticleComponent, InSignificance);
+	}
+
+	for (const FAreaSoundInfo& AreaSoundInfo : AreaSoundInfos)
+	{
+		UCombatSignificanceSubsystem::ApplyToAudio(AreaSoundInfo.AudioComponent.Get(), InSignificance);
+	}
+}
+#endif
+
 void UAreaComponent::CheckOverlap(const float InDeltaTime)
 {
+	COMBAT_PERF_SCOPE(AreaOverlap);
+
 	for (int Index = 0; Index < OverlapInfoList.Num(); Index++)
 	{
 		// 패턴 오버랩 구간별 딜레이 체크
@@ -523,7 +627,7 @@ void UAreaComponent::CheckOverlap(const float InDeltaTime)
 
 					if (GetAreaInfo().AreaSectionTime <= OverlappedTime)
 					{
-						OnAreaIn(InDeltaTime, Result.GetActor(), Result.GetComponent());
+						NotifyAreaIn(InDeltaTime, Result.GetActor(), Result.GetComponent());
 
 						OverlappedTime = 0.f;
 					}
@@ -531,7 +635,7 @@ void UAreaComponent::CheckOverlap(const float InDeltaTime)
 				else
 				{
 					// 도트효과가 아닌 경우 오버랩 패턴(구간)을 별개로 처리하여 여러번 맞을 수 있음.
-					OnAreaIn(InDeltaTime, Result.GetActor(), Result.GetComponent());
+					NotifyAreaIn(InDeltaTime, Result.GetActor(), Result.GetComponent());
 				}
 
 				OverlapInfoList[Index].OverlappedActorList.Emplace(Result.GetActor());
@@ -558,4 +662,20 @@ void UAreaComponent::CheckOverlap(const float InDeltaTime)
 			continue;
 		}
 	}
-}
\ No newline at end of file
+}
+
+void UAreaComponent::NotifyAreaIn(const float InDeltaTime, AActor* OtherActor, UPrimitiveComponent* OtherComp)
+{
+	if (ICombatHitPolicy* HitPolicy = UProjectileSubsystem::GetHitPolicy(GetWorld()))
+	{
+		HitPolicy->OnHit(ECombatHitKind::Area, CalculatedAreaInfo.Caster, OtherActor, true);
+
+		// 대역이 만든 장판은 판정만 재고 효과는 적용하지 않는다.
+		if (HitPolicy->IsSimulatedCaster(CalculatedAreaInfo.Caster))
+		{
+			return;
+		}
+	}
+
+	OnAreaIn(InDeltaTime, OtherActor, OtherComp);
+}
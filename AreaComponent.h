@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
+#include "CombatSignificanceSubsystem.h"
 #include "AreaComponent.generated.h"
 
 USTRUCT()
@@ -64,6 +65,8 @@ public:
 
 	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
 
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 
 public:
 	// 자식에서 상속해서 사용
@@ -75,32 +78,47 @@ public:
 	inline const FSkillAreaInfo& GetAreaInfo() const { return CalculatedAreaInfo; }
 	inline const TWeakObjectPtr<ACustomPlayerState> GetCasterState() const { return CasterState; }
 
+	/** Init 에서 쓰는 계산. 같은 Timestamp 면 항상 같은 결과 (HazardSimulation 에서도 사용) */
+	static void CalculateAreaInfo(const FSkillAreaInfo& InAreaInfo, FSkillAreaInfo& OutCalculatedAreaInfo);
+	static void BuildOverlapInfos(const FSkillAreaInfo& InCalculatedAreaInfo, TArray<FAreaOverlapInfo>& OutOverlapInfos);
+
+	/** HazardSimulation 에서 OnAreaIn 을 호출하기 위해 등록하지 않은 컴포넌트에 값만 채운다. */
+	void InitBridge(const FSkillAreaInfo& InCalculatedAreaInfo);
+
 	inline void SetActiveArea(const bool InValue) { bActiveArea = InValue; }
 	inline const bool IsActiveArea() const { return bActiveArea; }
 	const bool IsEnd() const;
 	void OnEnd();
 
 private:
-	void CreateOverlapInfo(const FSkillAreaInfo& InAreaInfo);
+#if !UE_SERVER
 	void CreateDecal(const FSkillAreaInfo& InAreaInfo);
 	void CreateParticle(const FSkillAreaInfo& InAreaInfo);
 	void CreateSound(const FSkillAreaInfo& InAreaInfo);
 
+	void TickParticleAndSound();
+	void ReleaseSounds(const bool bInRemove);
+
+	void RegisterSignificance();
+	void ApplySignificance(const ECombatSignificance InSignificance);
+#endif
+
 	void CheckOverlap(const float InDeltaTime);
+	void NotifyAreaIn(const float InDeltaTime, AActor* OtherActor, UPrimitiveComponent* OtherComp);
 
 #if WITH_EDITOR
 	void DrawOverlapDebug(const FAreaOverlapInfo& InOverlapInfo);
 #endif
 
 private:
-	UPROPERTY()
-	UDecalComponent* DecalComponent;
+#if !UE_SERVER
+	// 서버 빌드에서는 없음. (UPROPERTY 대신 AddReferencedObjects 로 참조)
+	UDecalComponent* DecalComponent = nullptr;
 
-	UPROPERTY()
 	TArray<UParticleSystemComponent*> ParticleComponents;
 
-	UPROPERTY()
 	TArray<FAreaSoundInfo> AreaSoundInfos;
+#endif
 
 	UPROPERTY()
 	TArray<FAreaOverlapInfo> OverlapInfoList;
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BenchmarkHarness.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBenchmark, Log, All);
+
+FBenchmarkCsv::FBenchmarkCsv(const TCHAR* InName, const FString& InOutputPath, const TCHAR* InHeader)
+	: Name(InName)
+	, OutputPath(ResolveOutputPath(InName, InOutputPath))
+	, Text(FString(InHeader) + TEXT("\n"))
+{
+}
+
+void FBenchmarkCsv::AddRow(const FString& InRow)
+{
+	Text += InRow + TEXT("\n");
+}
+
+void FBenchmarkCsv::AddSummary(const FString& InSummary)
+{
+	Text += TEXT("# ") + InSummary + TEXT("\n");
+	UE_LOG(LogBenchmark, Log, TEXT("[%s] %s"), *Name, *InSummary);
+}
+
+bool FBenchmarkCsv::Save() const
+{
+	if (FFileHelper::SaveStringToFile(Text, *OutputPath) == false)
+	{
+		UE_LOG(LogBenchmark, Warning, TEXT("[%s] Failed to write %s"), *Name, *OutputPath);
+		return false;
+	}
+
+	UE_LOG(LogBenchmark, Log, TEXT("[%s] Benchmark written: %s"), *Name, *OutputPath);
+	return true;
+}
+
+FString FBenchmarkCsv::ResolveOutputPath(const TCHAR* InName, const FString& InOutputPath)
+{
+	if (InOutputPath.IsEmpty() == false)
+	{
+		return InOutputPath;
+	}
+
+	return FPaths::ProfilingDir() / InName / (FDateTime::Now().ToString() + TEXT(".csv"));
+}
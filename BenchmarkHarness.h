@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 벤치마크 콘솔 명령의 "Key=Value" 인자 */
+class FBenchmarkArgs
+{
+public:
+	explicit FBenchmarkArgs(const TArray<FString>& InArgs)
+		: Params(FString::Join(InArgs, TEXT(" ")))
+	{
+	}
+
+	template<typename T>
+	inline bool Value(const TCHAR* InKey, T& OutValue) const { return FParse::Value(*Params, InKey, OutValue); }
+	inline bool Bool(const TCHAR* InKey, bool& OutValue) const { return FParse::Bool(*Params, InKey, OutValue); }
+
+private:
+	FString Params;
+};
+
+/**
+ * 헤드리스 벤치마크(WidgetPool.Benchmark, Projectile.Benchmark) 결과 CSV.
+ * 프레임별 행 뒤에 '#' 로 시작하는 요약 줄을 붙이고, 요약 줄은 로그에도 남긴다.
+ * 출력 경로가 비어있으면 Saved/Profiling/<Name>/<DateTime>.csv
+ */
+class FBenchmarkCsv
+{
+public:
+	FBenchmarkCsv(const TCHAR* InName, const FString& InOutputPath, const TCHAR* InHeader);
+
+	void AddRow(const FString& InRow);
+	void AddSummary(const FString& InSummary);
+
+	bool Save() const;
+
+	inline const FString& GetOutputPath() const { return OutputPath; }
+
+	static FString ResolveOutputPath(const TCHAR* InName, const FString& InOutputPath);
+
+private:
+	FString Name;
+	FString OutputPath;
+	FString Text;
+};
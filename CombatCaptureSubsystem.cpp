@@ -0,0 +1,774 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatCaptureSubsystem.h"
+#include "CombatPerfCounters.h"
+#include "CustomProjectileActor.h"
+#include "Component/AreaComponent.h"
+#include "EngineUtils.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatCapture, Log, All);
+
+namespace CombatCapture
+{
+	static const uint32 Magic = 0x50414343; // 'CCAP'
+	static const uint32 Version = 2;
+
+	/** 구조체는 태그 직렬화(필드 추가/삭제에 안전)하고, 에셋은 경로 문자열로 저장한다. */
+	static void SerializeStruct(FArchive& Ar, UScriptStruct* InStruct, void* InData)
+	{
+		TArray<uint8> Bytes;
+		if (Ar.IsSaving())
+		{
+			FMemoryWriter MemWriter(Bytes);
+			FObjectAndNameAsStringProxyArchive Proxy(MemWriter, false);
+			InStruct->SerializeItem(Proxy, InData, nullptr);
+			Ar << Bytes;
+		}
+		else
+		{
+			Ar << Bytes;
+			if (InData != nullptr)
+			{
+				FMemoryReader MemReader(Bytes);
+				FObjectAndNameAsStringProxyArchive Proxy(MemReader, true);
+				InStruct->SerializeItem(Proxy, InData, nullptr);
+			}
+		}
+	}
+
+	static void SerializeId(FArchive& Ar, int32& InOutId)
+	{
+		// INDEX_NONE 를 담기 위해 1 을 더해서 저장
+		uint32 Packed = (uint32)(InOutId + 1);
+		Ar.SerializeIntPacked(Packed);
+		InOutId = (int32)Packed - 1;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCombatCaptureStartCommand(
+	TEXT("Combat.Capture.Start"),
+	TEXT("Start recording area/projectile spawns and character positions. Usage: Combat.Capture.Start [File]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UCombatCaptureSubsystem* Capture = World ? World->GetSubsystem<UCombatCaptureSubsystem>() : nullptr;
+		if (Capture != nullptr)
+		{
+			const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("CombatCapture") / (FDateTime::Now().ToString() + TEXT(".ccap"));
+			Capture->StartCapture(Filename);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GCombatCaptureStopCommand(
+	TEXT("Combat.Capture.Stop"),
+	TEXT("Stop recording."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UCombatCaptureSubsystem* Capture = World ? World->GetSubsystem<UCombatCaptureSubsystem>() : nullptr;
+		if (Capture != nullptr)
+		{
+			Capture->StopCapture();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GCombatReplayCommand(
+	TEXT("Combat.Replay"),
+	TEXT("Replay a combat capture and report CheckOverlap/CheckSweep cost and hit differences. Usage: Combat.Replay <File>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UCombatCaptureSubsystem* Capture = World ? World->GetSubsystem<UCombatCaptureSubsystem>() : nullptr;
+		if (Capture != nullptr && Args.Num() > 0)
+		{
+			Capture->StartReplay(Args[0]);
+		}
+	}));
+
+void UCombatCaptureSubsystem::Deinitialize()
+{
+	StopCapture();
+	StopReplay();
+
+	Super::Deinitialize();
+}
+
+void UCombatCaptureSubsystem::Tick(float DeltaTime)
+{
+	if (IsCapturing())
+	{
+		TickCapture(DeltaTime);
+	}
+	else if (IsReplaying())
+	{
+		TickReplay();
+	}
+}
+
+bool UCombatCaptureSubsystem::StartCapture(const FString& InFilename)
+{
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (IsCapturing() || IsReplaying() || GetWorld()->GetNetMode() == NM_Client || ProjectileSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	CaptureWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*InFilename));
+	if (CaptureWriter.IsValid() == false)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Failed to open %s"), *InFilename);
+		return false;
+	}
+
+	if (ProjectileSubsystem->SetHitPolicy(this) == false)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Another hit policy (benchmark) is active."));
+		CaptureWriter.Reset();
+		return false;
+	}
+
+	uint32 Magic = CombatCapture::Magic;
+	uint32 Version = CombatCapture::Version;
+	FString MapName = GetWorld()->GetMapName();
+	*CaptureWriter << Magic << Version << MapName;
+
+	ActorIds.Empty();
+	IdToActor.Empty();
+	NextActorId = 0;
+
+	UE_LOG(LogCombatCapture, Log, TEXT("Capture started: %s"), *InFilename);
+	return true;
+}
+
+void UCombatCaptureSubsystem::StopCapture()
+{
+	if (IsCapturing() == false)
+	{
+		return;
+	}
+
+	uint8 Type = (uint8)ERecordType::End;
+	*CaptureWriter << Type;
+	CaptureWriter->Close();
+	CaptureWriter.Reset();
+
+	if (UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>())
+	{
+		ProjectileSubsystem->ClearHitPolicy(this);
+	}
+
+	ActorIds.Empty();
+	IdToActor.Empty();
+
+	UE_LOG(LogCombatCapture, Log, TEXT("Capture stopped."));
+}
+
+void UCombatCaptureSubsystem::OnAreaInit(const UAreaComponent* InArea, const FSkillAreaInfo& InAreaInfo)
+{
+	if (IsCapturing() == false || IsValid(InArea) == false)
+	{
+		return;
+	}
+
+	ACustomCharacter* InCaster = InAreaInfo.Caster;
+	if (IsValid(InCaster) == false)
+	{
+		return;
+	}
+
+	int32 CasterId = FindOrAddCaptureId(InCaster);
+	FVector CasterLocation = InCaster->GetActorLocation();
+	float CasterYaw = InCaster->GetActorRotation().Yaw;
+	FString AreaClassPath = InArea->GetClass()->GetPathName();
+
+	FSkillAreaInfo AreaInfo = InAreaInfo;
+	AreaInfo.Caster = nullptr;
+
+	uint8 Type = (uint8)ERecordType::AreaInit;
+	*CaptureWriter << Type;
+	CombatCapture::SerializeId(*CaptureWriter, CasterId);
+	*CaptureWriter << CasterLocation << CasterYaw << AreaClassPath;
+	CombatCapture::SerializeStruct(*CaptureWriter, FSkillAreaInfo::StaticStruct(), &AreaInfo);
+}
+
+void UCombatCaptureSubsystem::OnProjectileFire(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern, const bool bInPierceable)
+{
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(InProjectileInfo.Caster);
+	if (IsCapturing() == false || IsValid(InCaster) == false)
+	{
+		return;
+	}
+
+	int32 CasterId = FindOrAddCaptureId(InCaster);
+	ACustomCharacter* InTarget = Cast<ACustomCharacter>(InProjectileInfo.Target);
+	int32 TargetId = IsValid(InTarget) ? FindOrAddCaptureId(InTarget) : INDEX_NONE;
+	FVector CasterLocation = InCaster->GetActorLocation();
+	float CasterYaw = InCaster->GetActorRotation().Yaw;
+	FString ProjectileClassPath = InProjectileClass != nullptr ? InProjectileClass->GetPathName() : FString();
+	FTransform SpawnTM = InSpawnTM;
+	bool bPierceable = bInPierceable;
+
+	// 대역에는 PlayerState 가 없으므로 발사 시점의 되감기 시간을 남긴다.
+	const UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	float RewindMs = ProjectileSubsystem ? ProjectileSubsystem->GetLagCompRewindMs(InCaster) : 0.f;
+
+	FProjectileVolleyPattern Pattern = InPattern;
+
+	FSkillProjectileInfo ProjectileInfo = InProjectileInfo;
+	ProjectileInfo.Caster = nullptr;
+	ProjectileInfo.Target = nullptr;
+
+	uint8 Type = (uint8)ERecordType::ProjectileFire;
+	*CaptureWriter << Type;
+	CombatCapture::SerializeId(*CaptureWriter, CasterId);
+	CombatCapture::SerializeId(*CaptureWriter, TargetId);
+	*CaptureWriter << CasterLocation << CasterYaw << ProjectileClassPath << SpawnTM << bPierceable << RewindMs;
+	CombatCapture::SerializeStruct(*CaptureWriter, FProjectileVolleyPattern::StaticStruct(), &Pattern);
+	CombatCapture::SerializeStruct(*CaptureWriter, FSkillProjectileInfo::StaticStruct(), &ProjectileInfo);
+}
+
+void UCombatCaptureSubsystem::OnHit(const ECombatHitKind InKind, AActor* InCaster, AActor* InTarget, const bool bInCanAttack)
+{
+	FCombatCaptureHit NewHit;
+	NewHit.Kind = InKind;
+	NewHit.bCanAttack = bInCanAttack;
+
+	if (IsReplaying())
+	{
+		NewHit.CasterId = FindActorId(InCaster);
+		NewHit.TargetId = FindActorId(InTarget);
+		ReplayedHits.Emplace(NewHit);
+		return;
+	}
+
+	if (IsCapturing())
+	{
+		// 이번 프레임에 스폰된 캐릭터는 아직 Frame 에 기록되지 않았을 수 있다.
+		ACustomCharacter* CasterCharacter = Cast<ACustomCharacter>(InCaster);
+		ACustomCharacter* TargetCharacter = Cast<ACustomCharacter>(InTarget);
+		NewHit.CasterId = IsValid(CasterCharacter) ? FindOrAddCaptureId(CasterCharacter) : INDEX_NONE;
+		NewHit.TargetId = IsValid(TargetCharacter) ? FindOrAddCaptureId(TargetCharacter) : INDEX_NONE;
+
+		uint8 Type = (uint8)ERecordType::Hit;
+		uint8 Kind = (uint8)NewHit.Kind;
+		*CaptureWriter << Type << Kind;
+		CombatCapture::SerializeId(*CaptureWriter, NewHit.CasterId);
+		CombatCapture::SerializeId(*CaptureWriter, NewHit.TargetId);
+		*CaptureWriter << NewHit.bCanAttack;
+	}
+}
+
+bool UCombatCaptureSubsystem::IsSimulatedCaster(const AActor* InCaster) const
+{
+	// 재생 중에는 ActorIds 에 대역만 있다.
+	return IsReplaying() && FindActorId(InCaster) != INDEX_NONE;
+}
+
+bool UCombatCaptureSubsystem::CanAttack(ACustomCharacter* InCaster, AActor* InTarget) const
+{
+	const TArray<TPair<int32, bool>>* History = AttackableHistory.Find(TPair<int32, int32>(FindActorId(InCaster), FindActorId(InTarget)));
+	if (History == nullptr)
+	{
+		return true;
+	}
+
+	// 이번 재생 프레임 이전의 마지막 기록. 없으면 첫 기록 (스폰 시점 차이로 한 프레임 어긋날 수 있다.)
+	const int32 NextIndex = Algo::UpperBoundBy(*History, ReplayFrameCount, [](const TPair<int32, bool>& Entry) { return Entry.Key; });
+	return (*History)[FMath::Max(NextIndex - 1, 0)].Value;
+}
+
+bool UCombatCaptureSubsystem::CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo) const
+{
+	// 관통 여부는 시전자의 스킬 상태에 따르므로 녹화된 값을 쓴다.
+	return bReplayPierceable;
+}
+
+float UCombatCaptureSubsystem::GetLagCompRewindMs(const ACustomCharacter* InCaster) const
+{
+	const float* RewindMs = ReplayRewindMs.Find(FObjectKey(InCaster));
+	return RewindMs ? *RewindMs : 0.f;
+}
+
+int32 UCombatCaptureSubsystem::FindActorId(const AActor* InActor) const
+{
+	const int32* FoundId = InActor ? ActorIds.Find(FObjectKey(InActor)) : nullptr;
+	return FoundId ? *FoundId : INDEX_NONE;
+}
+
+int32 UCombatCaptureSubsystem::FindOrAddCaptureId(ACustomCharacter* InCharacter)
+{
+	const FObjectKey CharacterKey(InCharacter);
+	if (const int32* FoundId = ActorIds.Find(CharacterKey))
+	{
+		return *FoundId;
+	}
+
+	int32 NewId = NextActorId++;
+	ActorIds.Add(CharacterKey, NewId);
+	IdToActor.Add(NewId, InCharacter);
+
+	FString ClassPath = InCharacter->GetClass()->GetPathName();
+
+	uint8 Type = (uint8)ERecordType::CharacterSpawn;
+	*CaptureWriter << Type;
+	CombatCapture::SerializeId(*CaptureWriter, NewId);
+	*CaptureWriter << ClassPath;
+
+	return NewId;
+}
+
+void UCombatCaptureSubsystem::TickCapture(const float InDeltaTime)
+{
+	// 사라진 캐릭터
+	for (auto It = IdToActor.CreateIterator(); It; ++It)
+	{
+		if (It.Value().IsValid() == false)
+		{
+			int32 Id = It.Key();
+			uint8 Type = (uint8)ERecordType::CharacterDespawn;
+			*CaptureWriter << Type;
+			CombatCapture::SerializeId(*CaptureWriter, Id);
+
+			It.RemoveCurrent();
+		}
+	}
+
+	TArray<ACustomCharacter*, TInlineAllocator<64>> Characters;
+	for (TActorIterator<ACustomCharacter> It(GetWorld()); It; ++It)
+	{
+		if (IsValid(*It))
+		{
+			FindOrAddCaptureId(*It);
+			Characters.Add(*It);
+		}
+	}
+
+	// Frame - 이 프레임 이후의 스폰은 이 위치를 기준으로 재생된다.
+	uint8 Type = (uint8)ERecordType::Frame;
+	float DeltaTime = InDeltaTime;
+	uint32 Count = Characters.Num();
+	*CaptureWriter << Type << DeltaTime;
+	CaptureWriter->SerializeIntPacked(Count);
+
+	for (ACustomCharacter* Character : Characters)
+	{
+		int32 Id = FindActorId(Character);
+		FVector Location = Character->GetActorLocation();
+		uint16 Yaw = FRotator::CompressAxisToShort(Character->GetActorRotation().Yaw);
+
+		CombatCapture::SerializeId(*CaptureWriter, Id);
+		*CaptureWriter << Location << Yaw;
+	}
+}
+
+bool UCombatCaptureSubsystem::StartReplay(const FString& InFilename)
+{
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (IsCapturing() || IsReplaying() || ProjectileSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	if (FFileHelper::LoadFileToArray(ReplayData, *InFilename) == false)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Failed to load %s"), *InFilename);
+		return false;
+	}
+
+	ReplayReader = MakeUnique<FMemoryReader>(ReplayData);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FString MapName;
+	*ReplayReader << Magic << Version << MapName;
+	if (Magic != CombatCapture::Magic || Version != CombatCapture::Version)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("%s is not a combat capture (version %u)."), *InFilename, Version);
+		ReplayReader.Reset();
+		ReplayData.Empty();
+		return false;
+	}
+
+	if (MapName != GetWorld()->GetMapName())
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Capture was recorded on %s, replaying on %s."), *MapName, *GetWorld()->GetMapName());
+	}
+
+	if (ProjectileSubsystem->SetHitPolicy(this) == false)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Another hit policy (benchmark) is active."));
+		ReplayReader.Reset();
+		ReplayData.Empty();
+		return false;
+	}
+
+	// 사전 스캔 - 기대 결과와 프레임별 공격 가능 여부를 먼저 모은다.
+	const int64 BodyOffset = ReplayReader->Tell();
+	ExpectedHits.Reset();
+	AttackableHistory.Reset();
+
+	int32 ScanFrameCount = 0;
+	ERecordType Type = ERecordType::End;
+	while (ReplayReader->AtEnd() == false && ReadRecord(*ReplayReader, Type, false) && Type != ERecordType::End)
+	{
+		if (Type == ERecordType::Frame)
+		{
+			ScanFrameCount++;
+		}
+		else if (Type == ERecordType::Hit && ExpectedHits.Last().Kind == ECombatHitKind::Projectile)
+		{
+			// 장판은 공격 가능 여부를 보지 않는다.
+			const FCombatCaptureHit& Hit = ExpectedHits.Last();
+			TArray<TPair<int32, bool>>& History = AttackableHistory.FindOrAdd(TPair<int32, int32>(Hit.CasterId, Hit.TargetId));
+			if (History.Num() == 0 || History.Last().Value != Hit.bCanAttack)
+			{
+				History.Emplace(ScanFrameCount, Hit.bCanAttack);
+			}
+		}
+	}
+
+	ReplayReader->Seek(BodyOffset);
+
+	bReplaying = true;
+	ReplayedHits.Reset();
+	ReplayFrameCount = 0;
+	ReplayStartTime = FPlatformTime::Seconds();
+
+	// 녹화된 프레임 시간대로 진행
+	bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+
+	FMath::RandInit(0);
+
+	FCombatPerfCounters::Reset();
+	FCombatPerfCounters::bEnabled = true;
+
+	UE_LOG(LogCombatCapture, Log, TEXT("Replay started: %s (%d hits expected)"), *InFilename, ExpectedHits.Num());
+	return true;
+}
+
+void UCombatCaptureSubsystem::StopReplay()
+{
+	if (IsReplaying() == false)
+	{
+		return;
+	}
+
+	bReplaying = false;
+
+	FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+	FCombatPerfCounters::bEnabled = false;
+
+	for (TWeakObjectPtr<UAreaComponent>& Area : ReplayAreas)
+	{
+		if (Area.IsValid()) Area->DestroyComponent();
+	}
+
+	for (TPair<int32, TWeakObjectPtr<ACustomCharacter>>& Proxy : Proxies)
+	{
+		if (Proxy.Value.IsValid()) Proxy.Value->Destroy();
+	}
+
+	if (UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>())
+	{
+		ProjectileSubsystem->ClearHitPolicy(this);
+	}
+
+	ReplayRewindMs.Empty();
+	AttackableHistory.Empty();
+	ReplayAreas.Empty();
+	Proxies.Empty();
+	ActorIds.Empty();
+	ReplayReader.Reset();
+	ReplayData.Empty();
+}
+
+void UCombatCaptureSubsystem::TickReplay()
+{
+	// 끝난 장판 정리 (원래는 장판을 만든 쪽에서 처리)
+	for (int Index = 0; Index < ReplayAreas.Num(); Index++)
+	{
+		if (ReplayAreas[Index].IsValid() == false || ReplayAreas[Index]->IsEnd())
+		{
+			if (ReplayAreas[Index].IsValid()) ReplayAreas[Index]->DestroyComponent();
+			ReplayAreas.RemoveAtSwap(Index--);
+		}
+	}
+
+	// 프레임 하나와 그 뒤의 스폰들을 실행
+	bool bFrameConsumed = false;
+	while (true)
+	{
+		if (ReplayReader->AtEnd())
+		{
+			FinishReplay();
+			return;
+		}
+
+		const int64 RecordOffset = ReplayReader->Tell();
+
+		uint8 PeekType = 0;
+		*ReplayReader << PeekType;
+		ReplayReader->Seek(RecordOffset);
+
+		if ((ERecordType)PeekType == ERecordType::Frame && bFrameConsumed == true)
+		{
+			// 다음 프레임의 시간을 미리 읽어 다음 엔진 프레임의 DeltaTime 으로 쓴다.
+			float NextDeltaTime = 0.f;
+			*ReplayReader << PeekType << NextDeltaTime;
+			ReplayReader->Seek(RecordOffset);
+
+			FApp::SetFixedDeltaTime(NextDeltaTime);
+			break;
+		}
+
+		ERecordType Type = ERecordType::End;
+		if (ReadRecord(*ReplayReader, Type, true) == false || Type == ERecordType::End)
+		{
+			FinishReplay();
+			return;
+		}
+
+		if (Type == ERecordType::Frame)
+		{
+			bFrameConsumed = true;
+			ReplayFrameCount++;
+		}
+	}
+}
+
+bool UCombatCaptureSubsystem::ReadRecord(FArchive& Ar, ERecordType& OutType, const bool bInApply)
+{
+	uint8 Type = 0;
+	Ar << Type;
+	OutType = (ERecordType)Type;
+
+	switch (OutType)
+	{
+	case ERecordType::Frame:
+	{
+		float DeltaTime = 0.f;
+		uint32 Count = 0;
+		Ar << DeltaTime;
+		Ar.SerializeIntPacked(Count);
+
+		for (uint32 Index = 0; Index < Count && Ar.IsError() == false; Index++)
+		{
+			int32 Id = INDEX_NONE;
+			FVector Location;
+			uint16 Yaw = 0;
+			CombatCapture::SerializeId(Ar, Id);
+			Ar << Location << Yaw;
+
+			if (bInApply == true)
+			{
+				FindProxy(Id, Location, FRotator::DecompressAxisFromShort(Yaw));
+			}
+		}
+		break;
+	}
+	case ERecordType::CharacterSpawn:
+	{
+		int32 Id = INDEX_NONE;
+		FString ClassPath;
+		CombatCapture::SerializeId(Ar, Id);
+		Ar << ClassPath;
+
+		if (bInApply == true) ReplayCharacterSpawn(Id, ClassPath);
+		break;
+	}
+	case ERecordType::CharacterDespawn:
+	{
+		int32 Id = INDEX_NONE;
+		CombatCapture::SerializeId(Ar, Id);
+
+		if (bInApply == true) ReplayCharacterDespawn(Id);
+		break;
+	}
+	case ERecordType::AreaInit:
+	{
+		int32 CasterId = INDEX_NONE;
+		FVector CasterLocation;
+		float CasterYaw = 0.f;
+		FString AreaClassPath;
+		CombatCapture::SerializeId(Ar, CasterId);
+		Ar << CasterLocation << CasterYaw << AreaClassPath;
+
+		FSkillAreaInfo AreaInfo;
+		CombatCapture::SerializeStruct(Ar, FSkillAreaInfo::StaticStruct(), bInApply ? &AreaInfo : nullptr);
+
+		if (bInApply == true)
+		{
+			ACustomCharacter* Caster = FindProxy(CasterId, CasterLocation, CasterYaw);
+			UClass* AreaClass = LoadClass<UAreaComponent>(nullptr, *AreaClassPath);
+			if (IsValid(Caster) && AreaClass != nullptr)
+			{
+				AreaInfo.Caster = Caster;
+
+				UAreaComponent* NewArea = NewObject<UAreaComponent>(Caster, AreaClass);
+				NewArea->RegisterComponent();
+				NewArea->Init(AreaInfo);
+				NewArea->SetActiveArea(true);
+				ReplayAreas.Add(NewArea);
+			}
+		}
+		break;
+	}
+	case ERecordType::ProjectileFire:
+	{
+		int32 CasterId = INDEX_NONE;
+		int32 TargetId = INDEX_NONE;
+		FVector CasterLocation;
+		float CasterYaw = 0.f;
+		FString ProjectileClassPath;
+		FTransform SpawnTM;
+		bool bPierceable = false;
+		float RewindMs = 0.f;
+		CombatCapture::SerializeId(Ar, CasterId);
+		CombatCapture::SerializeId(Ar, TargetId);
+		Ar << CasterLocation << CasterYaw << ProjectileClassPath << SpawnTM << bPierceable << RewindMs;
+
+		FProjectileVolleyPattern Pattern;
+		FSkillProjectileInfo ProjectileInfo;
+		CombatCapture::SerializeStruct(Ar, FProjectileVolleyPattern::StaticStruct(), bInApply ? &Pattern : nullptr);
+		CombatCapture::SerializeStruct(Ar, FSkillProjectileInfo::StaticStruct(), bInApply ? &ProjectileInfo : nullptr);
+
+		UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+		if (bInApply == true && ProjectileSubsystem != nullptr)
+		{
+			ACustomCharacter* Caster = FindProxy(CasterId, CasterLocation, CasterYaw);
+			if (IsValid(Caster))
+			{
+				const TWeakObjectPtr<ACustomCharacter>* Target = Proxies.Find(TargetId);
+				ProjectileInfo.Caster = Caster;
+				ProjectileInfo.Target = Target ? Target->Get() : nullptr;
+
+				TSubclassOf<ACustomProjectileActor> ProjectileClass = ProjectileClassPath.IsEmpty() ? nullptr : LoadClass<ACustomProjectileActor>(nullptr, *ProjectileClassPath);
+
+				// 발사 후 핑 변화는 반영되지 않음
+				ReplayRewindMs.Add(FObjectKey(Caster), RewindMs);
+				bReplayPierceable = bPierceable;
+
+				ProjectileSubsystem->FireVolley(ProjectileClass, SpawnTM, ProjectileInfo, Pattern);
+			}
+		}
+		break;
+	}
+	case ERecordType::Hit:
+	{
+		FCombatCaptureHit Hit;
+		uint8 Kind = 0;
+		Ar << Kind;
+		CombatCapture::SerializeId(Ar, Hit.CasterId);
+		CombatCapture::SerializeId(Ar, Hit.TargetId);
+		Ar << Hit.bCanAttack;
+		Hit.Kind = (ECombatHitKind)Kind;
+
+		if (bInApply == false) ExpectedHits.Emplace(Hit);
+		break;
+	}
+	case ERecordType::End:
+		break;
+	default:
+		UE_LOG(LogCombatCapture, Warning, TEXT("Unknown record type %d"), Type);
+		return false;
+	}
+
+	return Ar.IsError() == false;
+}
+
+void UCombatCaptureSubsystem::ReplayCharacterSpawn(const int32 InId, const FString& InClassPath)
+{
+	UClass* CharacterClass = LoadClass<ACustomCharacter>(nullptr, *InClassPath);
+	if (CharacterClass == nullptr)
+	{
+		UE_LOG(LogCombatCapture, Warning, TEXT("Failed to load %s"), *InClassPath);
+		return;
+	}
+
+	// 컨트롤러 없는 대역. 위치는 Frame 에서 갱신한다.
+	ACustomCharacter* Proxy = GetWorld()->SpawnActorDeferred<ACustomCharacter>(CharacterClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Proxy == nullptr)
+	{
+		return;
+	}
+
+	Proxy->AutoPossessAI = EAutoPossessAI::Disabled;
+	Proxy->FinishSpawning(FTransform::Identity);
+
+	Proxies.Add(InId, Proxy);
+	ActorIds.Add(FObjectKey(Proxy), InId);
+}
+
+void UCombatCaptureSubsystem::ReplayCharacterDespawn(const int32 InId)
+{
+	TWeakObjectPtr<ACustomCharacter> Proxy;
+	if (Proxies.RemoveAndCopyValue(InId, Proxy) && Proxy.IsValid())
+	{
+		ActorIds.Remove(FObjectKey(Proxy.Get()));
+		Proxy->Destroy();
+	}
+}
+
+ACustomCharacter* UCombatCaptureSubsystem::FindProxy(const int32 InId, const FVector& InLocation, const float InYaw) const
+{
+	const TWeakObjectPtr<ACustomCharacter>* Proxy = Proxies.Find(InId);
+	if (Proxy == nullptr || Proxy->IsValid() == false)
+	{
+		return nullptr;
+	}
+
+	(*Proxy)->SetActorLocationAndRotation(InLocation, FRotator(0.f, InYaw, 0.f), false, nullptr, ETeleportType::TeleportPhysics);
+	return Proxy->Get();
+}
+
+void UCombatCaptureSubsystem::FinishReplay()
+{
+	const double WallTime = FPlatformTime::Seconds() - ReplayStartTime;
+
+	// 프레임 단위 순서는 스폰 시점 차이로 한 프레임씩 어긋날 수 있으므로 세션 전체의 판정 목록을 비교한다.
+	TArray<FCombatCaptureHit> Expected = ExpectedHits;
+	TArray<FCombatCaptureHit> Replayed = ReplayedHits;
+	Expected.Sort();
+	Replayed.Sort();
+
+	int32 Missing = 0;
+	int32 Extra = 0;
+	int32 ExpectedIndex = 0;
+	int32 ReplayedIndex = 0;
+	while (ExpectedIndex < Expected.Num() || ReplayedIndex < Replayed.Num())
+	{
+		if (ReplayedIndex >= Replayed.Num() || (ExpectedIndex < Expected.Num() && Expected[ExpectedIndex] < Replayed[ReplayedIndex]))
+		{
+			Missing++;
+			ExpectedIndex++;
+		}
+		else if (ExpectedIndex >= Expected.Num() || Replayed[ReplayedIndex] < Expected[ExpectedIndex])
+		{
+			Extra++;
+			ReplayedIndex++;
+		}
+		else
+		{
+			ExpectedIndex++;
+			ReplayedIndex++;
+		}
+	}
+
+	UE_LOG(LogCombatCapture, Log, TEXT("Replay finished: %d frames, %.2fs wall"), ReplayFrameCount, WallTime);
+	UE_LOG(LogCombatCapture, Log, TEXT("  Area CheckOverlap   : %lld calls, %.3f ms"), FCombatPerfCounters::AreaOverlap.Calls, FCombatPerfCounters::AreaOverlap.GetSeconds() * 1000.0);
+	UE_LOG(LogCombatCapture, Log, TEXT("  Projectile Sweep    : %lld calls, %.3f ms"), FCombatPerfCounters::ProjectileSweep.Calls, FCombatPerfCounters::ProjectileSweep.GetSeconds() * 1000.0);
+	UE_LOG(LogCombatCapture, Log, TEXT("  Hit Processing      : %lld calls, %.3f ms"), FCombatPerfCounters::HitProcessing.Calls, FCombatPerfCounters::HitProcessing.GetSeconds() * 1000.0);
+	UE_LOG(LogCombatCapture, Log, TEXT("  Hits                : %d expected, %d replayed, %d missing, %d extra -> %s"),
+		Expected.Num(), Replayed.Num(), Missing, Extra, (Missing == 0 && Extra == 0) ? TEXT("IDENTICAL") : TEXT("DIFFERENT"));
+
+	StopReplay();
+}
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileSubsystem.h"
+#include "CombatCaptureSubsystem.generated.h"
+
+class UAreaComponent;
+class ACustomProjectileActor;
+
+struct FCombatCaptureHit
+{
+	ECombatHitKind Kind = ECombatHitKind::Projectile;
+	int32 CasterId = INDEX_NONE;
+	int32 TargetId = INDEX_NONE;
+	bool bCanAttack = true;
+
+	inline bool operator<(const FCombatCaptureHit& Other) const
+	{
+		if (CasterId != Other.CasterId) return CasterId < Other.CasterId;
+		if (TargetId != Other.TargetId) return TargetId < Other.TargetId;
+		if (Kind != Other.Kind) return Kind < Other.Kind;
+		return bCanAttack < Other.bCanAttack;
+	}
+
+	inline bool operator==(const FCombatCaptureHit& Other) const
+	{
+		return Kind == Other.Kind && CasterId == Other.CasterId && TargetId == Other.TargetId && bCanAttack == Other.bCanAttack;
+	}
+};
+
+/**
+ * 서버 전투 스폰 흐름(장판 Init, 발사체 발사, 캐릭터 위치) 녹화와 재생.
+ * 재생은 녹화된 캐릭터 클래스로 만든 대역에게 같은 스폰을 다시 실행해서 판정 비용을 재고 판정 결과를 녹화와 비교한다.
+ * 원격 플레이어 발사체의 지연 보상은 발사 시점에 녹화한 되감기 시간으로 재현한다.
+ * 녹화와 재생 모두 UProjectileSubsystem 에 ICombatHitPolicy 로 등록해서 발사, 장판, 판정 결과를 받는다.
+ *
+ * Combat.Capture.Start [File] / Combat.Capture.Stop
+ * Combat.Replay <File>  (-nullrhi -benchmark 서버에서 실행)
+ */
+UCLASS()
+class UCombatCaptureSubsystem : public UWorldSubsystem, public FTickableGameObject, public ICombatHitPolicy
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false && (IsCapturing() || IsReplaying()); }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatCaptureSubsystem, STATGROUP_Tickables); }
+
+	bool StartCapture(const FString& InFilename);
+	void StopCapture();
+
+	bool StartReplay(const FString& InFilename);
+	void StopReplay();
+
+	inline bool IsCapturing() const { return CaptureWriter.IsValid(); }
+	inline bool IsReplaying() const { return bReplaying; }
+
+	/** ICombatHitPolicy - 재생 중에는 대역이 대신 판정받는다. */
+	virtual bool IsSimulatedCaster(const AActor* InCaster) const override;
+	virtual bool CanAttack(ACustomCharacter* InCaster, AActor* InTarget) const override;
+	virtual bool CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo) const override;
+	virtual float GetLagCompRewindMs(const ACustomCharacter* InCaster) const override;
+	virtual void OnProjectileFire(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern, const bool bInPierceable) override;
+	virtual void OnAreaInit(const UAreaComponent* InArea, const FSkillAreaInfo& InAreaInfo) override;
+	virtual void OnHit(const ECombatHitKind InKind, AActor* InCaster, AActor* InTarget, const bool bInCanAttack) override;
+
+private:
+	enum class ERecordType : uint8
+	{
+		Frame,
+		CharacterSpawn,
+		CharacterDespawn,
+		AreaInit,
+		ProjectileFire,
+		Hit,
+		End,
+	};
+
+	int32 FindActorId(const AActor* InActor) const;
+	int32 FindOrAddCaptureId(ACustomCharacter* InCharacter);
+
+	void TickCapture(const float InDeltaTime);
+	void TickReplay();
+
+	/** bInApply 가 false 이면 읽기만 한다. (사전 스캔) */
+	bool ReadRecord(FArchive& Ar, ERecordType& OutType, const bool bInApply);
+
+	void ReplayCharacterSpawn(const int32 InId, const FString& InClassPath);
+	void ReplayCharacterDespawn(const int32 InId);
+	ACustomCharacter* FindProxy(const int32 InId, const FVector& InLocation, const float InYaw) const;
+
+	void FinishReplay();
+
+private:
+	/** Capture */
+	TUniquePtr<FArchive> CaptureWriter;
+	TMap<FObjectKey, int32> ActorIds;
+	TMap<int32, TWeakObjectPtr<AActor>> IdToActor;
+	int32 NextActorId = 0;
+
+	/** Replay */
+	bool bReplaying = false;
+	TArray<uint8> ReplayData;
+	TUniquePtr<FArchive> ReplayReader;
+	TMap<int32, TWeakObjectPtr<ACustomCharacter>> Proxies;
+	TArray<TWeakObjectPtr<UAreaComponent>> ReplayAreas;
+
+	/** (시전자, 대상) 별 공격 가능 여부가 바뀐 프레임. 녹화 중 팀 관계가 바뀔 수 있으므로 프레임 단위로 찾는다. */
+	TMap<TPair<int32, int32>, TArray<TPair<int32, bool>>> AttackableHistory;
+
+	/** 발사 기록의 관통 여부와 되감기 시간. 되감기 시간은 발사체가 사라질 때까지 쓰이므로 시전자별로 다음 발사까지 유지한다. */
+	bool bReplayPierceable = false;
+	TMap<FObjectKey, float> ReplayRewindMs;
+
+	TArray<FCombatCaptureHit> ExpectedHits;
+	TArray<FCombatCaptureHit> ReplayedHits;
+	int32 ReplayFrameCount = 0;
+	double ReplayStartTime = 0.0;
+
+	bool bSavedUseFixedTimeStep = false;
+	double SavedFixedDeltaTime = 0.0;
+};
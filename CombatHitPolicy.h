@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class ACustomCharacter;
+class ACustomProjectileActor;
+class UAreaComponent;
+struct FSkillProjectileInfo;
+struct FSkillAreaInfo;
+struct FProjectileVolleyPattern;
+
+enum class ECombatHitKind : uint8
+{
+	Projectile,
+	Area,
+};
+
+/**
+ * 전투 판정을 지켜보거나 대신 처리하는 쪽(녹화/재생, 측정)이 UProjectileSubsystem::SetHitPolicy 로 등록하는 훅.
+ * 등록된 정책이 없으면 발사체와 장판은 게임 규칙 그대로 동작한다.
+ *
+ * 대역(정책이 직접 만든 캐릭터)에게는 팀 정보, 스킬 상태, PlayerState 가 없으므로
+ * 대역이 쏜 발사체는 스킬 검사를 건너뛰고, 공격 가능 여부/관통/되감기 시간을 정책에게 묻고, 데미지는 보내지 않는다.
+ */
+class ICombatHitPolicy
+{
+public:
+	virtual ~ICombatHitPolicy() {}
+
+	/** 정책이 만든 대역인지. 아래 대역 전용 함수는 이 값이 true 인 시전자에게만 호출된다. */
+	virtual bool IsSimulatedCaster(const AActor* InCaster) const = 0;
+
+	/** 대역 전용 */
+	virtual bool CanAttack(ACustomCharacter* InCaster, AActor* InTarget) const = 0;
+	virtual bool CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo) const = 0;
+	virtual float GetLagCompRewindMs(const ACustomCharacter* InCaster) const = 0;
+
+	/** 모든 시전자 - 발사, 장판 생성, 판정 결과 알림 */
+	virtual void OnProjectileFire(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern, const bool bInPierceable) = 0;
+	virtual void OnAreaInit(const UAreaComponent* InArea, const FSkillAreaInfo& InAreaInfo) = 0;
+	virtual void OnHit(const ECombatHitKind InKind, AActor* InCaster, AActor* InTarget, const bool bInCanAttack) = 0;
+};
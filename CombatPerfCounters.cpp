@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatPerfCounters.h"
+
+DEFINE_STAT(STAT_CombatAreaOverlap);
+DEFINE_STAT(STAT_CombatProjectileSweep);
+DEFINE_STAT(STAT_CombatHitProcessing);
+
+bool FCombatPerfCounters::bEnabled = false;
+
+FCombatPerfCounter FCombatPerfCounters::AreaOverlap;
+FCombatPerfCounter FCombatPerfCounters::ProjectileSweep;
+FCombatPerfCounter FCombatPerfCounters::HitProcessing;
+
+void FCombatPerfCounters::Reset()
+{
+	AreaOverlap.Reset();
+	ProjectileSweep.Reset();
+	HitProcessing.Reset();
+}
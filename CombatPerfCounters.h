@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat"), STATGROUP_Combat, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Area CheckOverlap"), STAT_CombatAreaOverlap, STATGROUP_Combat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Sweep"), STAT_CombatProjectileSweep, STATGROUP_Combat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Hit Processing"), STAT_CombatHitProcessing, STATGROUP_Combat, );
+
+struct FCombatPerfCounter
+{
+	uint64 Cycles = 0;
+	int64 Calls = 0;
+
+	inline double GetSeconds() const { return FPlatformTime::ToSeconds64(Cycles); }
+	inline void Reset() { Cycles = 0; Calls = 0; }
+};
+
+/**
+ * 리플레이, 벤치마크에서 읽는 판정 비용 누적값. (게임 스레드 전용)
+ * bEnabled 가 꺼져 있으면 stat 카운터만 동작한다.
+ */
+struct FCombatPerfCounters
+{
+	static bool bEnabled;
+
+	static FCombatPerfCounter AreaOverlap;
+	static FCombatPerfCounter ProjectileSweep;
+	static FCombatPerfCounter HitProcessing;
+
+	static void Reset();
+};
+
+class FScopedCombatPerfCounter
+{
+public:
+	explicit FScopedCombatPerfCounter(FCombatPerfCounter& InCounter)
+		: Counter(FCombatPerfCounters::bEnabled ? &InCounter : nullptr)
+		, StartCycles(Counter != nullptr ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FScopedCombatPerfCounter()
+	{
+		if (Counter != nullptr)
+		{
+			Counter->Cycles += FPlatformTime::Cycles64() - StartCycles;
+			Counter->Calls++;
+		}
+	}
+
+private:
+	FCombatPerfCounter* Counter;
+	uint64 StartCycles;
+};
+
+#define COMBAT_PERF_SCOPE(CounterName) \
+	SCOPE_CYCLE_COUNTER(STAT_Combat##CounterName); \
+	FScopedCombatPerfCounter CombatPerfScope_##CounterName(FCombatPerfCounters::CounterName)
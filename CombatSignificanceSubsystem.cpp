@@ -0,0 +1,270 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatSignificanceSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Components/AudioComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+
+static TAutoConsoleVariable<int32> CVarCombatSignificanceEnable(
+	TEXT("Combat.Significance.Enable"),
+	1,
+	TEXT("1: lower tick rate, particle LOD, lights and audio of distant or off-screen combat effects."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarCombatSignificanceUpdateInterval(
+	TEXT("Combat.Significance.UpdateInterval"),
+	0.1f,
+	TEXT("Seconds between significance updates."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarCombatSignificanceHighDistance(
+	TEXT("Combat.Significance.HighDistance"),
+	2000.f,
+	TEXT("Effects closer than this to a local view are High significance."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarCombatSignificanceMediumDistance(
+	TEXT("Combat.Significance.MediumDistance"),
+	4000.f,
+	TEXT("Effects closer than this to a local view are Medium significance."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarCombatSignificanceCullDistance(
+	TEXT("Combat.Significance.CullDistance"),
+	8000.f,
+	TEXT("Effects farther than this from every local view are culled."),
+	ECVF_Scalability);
+
+bool UCombatSignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	const UWorld* World = Cast<UWorld>(Outer);
+	return IsRunningDedicatedServer() == false && World != nullptr && World->IsGameWorld();
+#endif
+}
+
+void UCombatSignificanceSubsystem::Deinitialize()
+{
+	Entries.Empty();
+	LocalPawns.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatSignificanceSubsystem::Tick(float DeltaTime)
+{
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f || Entries.Num() == 0)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = CVarCombatSignificanceUpdateInterval.GetValueOnGameThread();
+
+	Entries.RemoveAllSwap([](const FCombatSignificanceEntry& Entry) { return Entry.Owner.IsValid() == false; });
+
+	UpdateViews();
+
+	// 알림 중에 등록/해제가 일어날 수 있으므로 바뀐 것만 모아서 나중에 알린다.
+	TArray<TPair<FOnCombatSignificanceChanged, ECombatSignificance>, TInlineAllocator<32>> Changed;
+
+	for (FCombatSignificanceEntry& Entry : Entries)
+	{
+		const ECombatSignificance NewSignificance = Evaluate(Entry.Desc);
+		if (NewSignificance != Entry.Significance)
+		{
+			Entry.Significance = NewSignificance;
+			Changed.Emplace(Entry.OnChanged, NewSignificance);
+		}
+	}
+
+	for (TPair<FOnCombatSignificanceChanged, ECombatSignificance>& Change : Changed)
+	{
+		Change.Key.ExecuteIfBound(Change.Value);
+	}
+}
+
+ECombatSignificance UCombatSignificanceSubsystem::Register(UObject* InOwner, const FCombatSignificanceDesc& InDesc, const FOnCombatSignificanceChanged& InOnChanged)
+{
+	if (IsValid(InOwner) == false)
+	{
+		return ECombatSignificance::Critical;
+	}
+
+	if (ViewLocations.Num() == 0)
+	{
+		UpdateViews();
+	}
+
+	FCombatSignificanceEntry& NewEntry = Entries.AddDefaulted_GetRef();
+	NewEntry.Owner = InOwner;
+	NewEntry.Desc = InDesc;
+	NewEntry.OnChanged = InOnChanged;
+	NewEntry.Significance = Evaluate(InDesc);
+
+	return NewEntry.Significance;
+}
+
+void UCombatSignificanceSubsystem::Unregister(UObject* InOwner)
+{
+	const int Index = Entries.IndexOfByPredicate([InOwner](const FCombatSignificanceEntry& Entry) { return Entry.Owner.Get() == InOwner; });
+	if (Index != INDEX_NONE)
+	{
+		Entries.RemoveAtSwap(Index);
+	}
+}
+
+float UCombatSignificanceSubsystem::GetTickInterval(const ECombatSignificance InSignificance)
+{
+	switch (InSignificance)
+	{
+	case ECombatSignificance::Medium:	return 1.f / 30.f;
+	case ECombatSignificance::Low:		return 1.f / 15.f;
+	case ECombatSignificance::Culled:	return 0.25f;
+	default:							return 0.f;
+	}
+}
+
+bool UCombatSignificanceSubsystem::ShouldSuppressLight(const ECombatSignificance InSignificance)
+{
+	return InSignificance >= ECombatSignificance::Low;
+}
+
+void UCombatSignificanceSubsystem::ApplyToParticle(UParticleSystemComponent* InParticle, const ECombatSignificance InSignificance)
+{
+	if (IsValid(InParticle) == false)
+	{
+		return;
+	}
+
+	InParticle->SetVisibility(InSignificance != ECombatSignificance::Culled);
+
+	// 템플릿에 만들어둔 LOD 를 더 싼 템플릿으로 사용한다.
+	if (InSignificance <= ECombatSignificance::High || InParticle->Template == nullptr)
+	{
+		InParticle->bOverrideLODMethod = false;
+		return;
+	}
+
+	const int32 MaxLODLevel = FMath::Max(InParticle->Template->LODDistances.Num() - 1, 0);
+	const int32 LODLevel = InSignificance == ECombatSignificance::Medium ? 1 : MaxLODLevel;
+
+	InParticle->bOverrideLODMethod = true;
+	InParticle->LODMethod = PARTICLESYSTEMLODMETHOD_DirectSet;
+	InParticle->SetLODLevel(FMath::Min(LODLevel, MaxLODLevel));
+}
+
+void UCombatSignificanceSubsystem::ApplyToAudio(UAudioComponent* InAudio, const ECombatSignificance InSignificance)
+{
+	if (IsValid(InAudio) == false)
+	{
+		return;
+	}
+
+	InAudio->SetPaused(InSignificance == ECombatSignificance::Culled);
+}
+
+void UCombatSignificanceSubsystem::UpdateViews()
+{
+	ViewLocations.Reset();
+	ViewDirs.Reset();
+	ViewCosHalfFOVs.Reset();
+	LocalPawns.Reset();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		if (IsValid(PlayerController) == false || PlayerController->IsLocalController() == false)
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		// 화면 가장자리 근처도 보이는 것으로 판정 (가로 FOV 기준, 여유 10도)
+		const float FOV = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() : 90.f;
+		const float HalfFOV = FMath::Min(FOV * 0.5f + 10.f, 90.f);
+
+		ViewLocations.Add(ViewLocation);
+		ViewDirs.Add(ViewRotation.Vector());
+		ViewCosHalfFOVs.Add(FMath::Cos(FMath::DegreesToRadians(HalfFOV)));
+
+		if (PlayerController->GetPawn() != nullptr)
+		{
+			LocalPawns.Add(PlayerController->GetPawn());
+		}
+	}
+}
+
+ECombatSignificance UCombatSignificanceSubsystem::Evaluate(const FCombatSignificanceDesc& InDesc) const
+{
+	if (CVarCombatSignificanceEnable.GetValueOnGameThread() == 0 || ViewLocations.Num() == 0)
+	{
+		return ECombatSignificance::Critical;
+	}
+
+	const FVector Location = InDesc.Origin.IsValid() ? InDesc.Origin->GetComponentLocation() : InDesc.Location;
+
+	// 로컬 플레이어의 공격, 로컬 플레이어를 향한 공격은 항상 최우선
+	for (const TWeakObjectPtr<const AActor>& LocalPawn : LocalPawns)
+	{
+		if (LocalPawn.IsValid() == false)
+		{
+			continue;
+		}
+
+		if (InDesc.Instigator == LocalPawn || InDesc.Target == LocalPawn)
+		{
+			return ECombatSignificance::Critical;
+		}
+
+		if (InDesc.ThreatRadius > 0.f && FVector::DistSquared2D(LocalPawn->GetActorLocation(), Location) <= FMath::Square(InDesc.ThreatRadius))
+		{
+			return ECombatSignificance::Critical;
+		}
+	}
+
+	// 가장 가까운 뷰 기준
+	float MinDistSquared = MAX_flt;
+	bool bOnScreen = false;
+	for (int ViewIndex = 0; ViewIndex < ViewLocations.Num(); ViewIndex++)
+	{
+		const FVector ToTarget = Location - ViewLocations[ViewIndex];
+		const float DistSquared = ToTarget.SizeSquared();
+		MinDistSquared = FMath::Min(MinDistSquared, DistSquared);
+
+		if (FVector::DotProduct(ToTarget.GetSafeNormal(), ViewDirs[ViewIndex]) >= ViewCosHalfFOVs[ViewIndex])
+		{
+			bOnScreen = true;
+		}
+	}
+
+	uint8 OutSignificance = (uint8)ECombatSignificance::Culled;
+	if (MinDistSquared < FMath::Square(CVarCombatSignificanceHighDistance.GetValueOnGameThread()))
+	{
+		OutSignificance = (uint8)ECombatSignificance::High;
+	}
+	else if (MinDistSquared < FMath::Square(CVarCombatSignificanceMediumDistance.GetValueOnGameThread()))
+	{
+		OutSignificance = (uint8)ECombatSignificance::Medium;
+	}
+	else if (MinDistSquared < FMath::Square(CVarCombatSignificanceCullDistance.GetValueOnGameThread()))
+	{
+		OutSignificance = (uint8)ECombatSignificance::Low;
+	}
+
+	// 화면 밖은 한 단계 낮춘다.
+	if (bOnScreen == false)
+	{
+		OutSignificance = FMath::Min<uint8>(OutSignificance + 1, (uint8)ECombatSignificance::Culled);
+	}
+
+	return (ECombatSignificance)OutSignificance;
+}
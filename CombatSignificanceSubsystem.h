@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "CombatSignificanceSubsystem.generated.h"
+
+class UParticleSystemComponent;
+class UAudioComponent;
+
+UENUM()
+enum class ECombatSignificance : uint8
+{
+	Critical,	// 로컬 플레이어가 쏜 공격, 로컬 플레이어를 노리는 공격
+	High,
+	Medium,
+	Low,
+	Culled,		// 멀거나 화면 밖. 보이지 않음
+};
+
+DECLARE_DELEGATE_OneParam(FOnCombatSignificanceChanged, ECombatSignificance);
+
+struct FCombatSignificanceDesc
+{
+	/** 위치를 따라갈 컴포넌트. 없으면 Location 고정 */
+	TWeakObjectPtr<USceneComponent> Origin;
+	FVector Location = FVector::ZeroVector;
+
+	TWeakObjectPtr<const AActor> Instigator;
+	TWeakObjectPtr<const AActor> Target;
+
+	/** 로컬 플레이어가 이 반경 안에 있으면 Critical (장판 등) */
+	float ThreatRadius = 0.f;
+};
+
+/**
+ * 클라이언트 전투 이펙트 중요도 관리. (데디케이티드 서버에서는 생성되지 않음)
+ * 거리와 화면 안 여부로 단계를 정하고, 단계가 바뀐 대상에게만 알린다.
+ * 틱 간격, 파티클 LOD, 라이트, 사운드는 각 대상이 단계에 맞춰 조절한다.
+ */
+UCLASS()
+class UCombatSignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatSignificanceSubsystem, STATGROUP_Tickables); }
+
+	/** 등록 시점의 단계를 바로 계산해서 반환한다. (InOnChanged 는 이후 바뀔 때만 호출) */
+	ECombatSignificance Register(UObject* InOwner, const FCombatSignificanceDesc& InDesc, const FOnCombatSignificanceChanged& InOnChanged);
+	void Unregister(UObject* InOwner);
+
+	/** 단계별 처리 */
+	static float GetTickInterval(const ECombatSignificance InSignificance);
+	static bool ShouldSuppressLight(const ECombatSignificance InSignificance);
+	static void ApplyToParticle(UParticleSystemComponent* InParticle, const ECombatSignificance InSignificance);
+	static void ApplyToAudio(UAudioComponent* InAudio, const ECombatSignificance InSignificance);
+
+	inline int32 GetNumRegistered() const { return Entries.Num(); }
+
+private:
+	struct FCombatSignificanceEntry
+	{
+		TWeakObjectPtr<UObject> Owner;
+		FCombatSignificanceDesc Desc;
+		FOnCombatSignificanceChanged OnChanged;
+		ECombatSignificance Significance = ECombatSignificance::Critical;
+	};
+
+	void UpdateViews();
+	ECombatSignificance Evaluate(const FCombatSignificanceDesc& InDesc) const;
+
+private:
+	TArray<FCombatSignificanceEntry> Entries;
+
+	/** Local views */
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	TArray<FVector, TInlineAllocator<4>> ViewDirs;
+	TArray<float, TInlineAllocator<4>> ViewCosHalfFOVs;
+	TArray<TWeakObjectPtr<const AActor>, TInlineAllocator<4>> LocalPawns;
+
+	float TimeUntilUpdate = 0.f;
+};
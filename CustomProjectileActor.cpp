@@ -1,6 +1,8 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "CustomProjectileActor.h"
+#include "ProjectileSubsystem.h"
+#include "CombatPerfCounters.h"
 #include "Components/SphereComponent.h"
 #include "Components/PointLightComponent.h"
 #include "Components/AudioComponent.h"
@@ -10,6 +12,24 @@
 #include "Particles/ParticleSystem.h"
 #include "CollisionQueryParams.h"
 
+static TAutoConsoleVariable<int32> CVarProjectileFixedStepForce(
+	TEXT("Projectile.FixedStep.Force"),
+	0,
+	TEXT("1: use fixed-step integration for every projectile regardless of bUseFixedStepIntegration."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarProjectileFixedStepHz(
+	TEXT("Projectile.FixedStep.Hz"),
+	60.f,
+	TEXT("Step rate of fixed-step projectile integration."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarProjectileFixedStepMaxSubSteps(
+	TEXT("Projectile.FixedStep.MaxSubSteps"),
+	8,
+	TEXT("Max fixed steps (and sweeps) per projectile per frame. Time beyond this budget is dropped, so the projectile falls behind instead of catching up."),
+	ECVF_Default);
+
 ACustomProjectileActor::ACustomProjectileActor(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -37,40 +57,52 @@ void ACustomProjectileActor::BeginPlay()
 
 void ACustomProjectileActor::Destroyed()
 {
+#if !UE_SERVER
+	UCombatSignificanceSubsystem* SignificanceSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCombatSignificanceSubsystem>() : nullptr;
+	if (SignificanceSubsystem) SignificanceSubsystem->Unregister(this);
+
 	DeActiveParticleComponent();
 	DeActiveAudioComponents();
+	UnregisterLight();
+#endif
 	Super::Destroyed();
 }
 
+void ACustomProjectileActor::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+#if !UE_SERVER
+	ACustomProjectileActor* This = CastChecked<ACustomProjectileActor>(InThis);
+	Collector.AddReferencedObject(This->SkeletalMeshComponent, This);
+	Collector.AddReferencedObject(This->ParticleSystemComponent, This);
+	Collector.AddReferencedObject(This->PointLightComponent, This);
+#endif
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
 void ACustomProjectileActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bActive == true && IsValid(Archetype) == false)
+	{
+		bActive = false;
+	}
+
 	if (bActive == true)
 	{
-		if (m_ProjectileInfo.FireDelay <= ElapsedTime)
+		if (PreElemTM.Num() == 0 && ShotInfo.FireDelay <= ElapsedTime)
+		{
+			Ignite();
+		}
+
+		if (bActive == true && PreElemTM.Num() > 0)
 		{
-			if (PreElemTM.Num() == 0)
+			if (FixedStep.bEnabled == true)
 			{
-				ACustomCharacter* InCaster = Cast<ACustomCharacter>(m_ProjectileInfo.Caster);
-				if (m_ProjectileInfo.SkillCID != NAME_None && (IsValid(InCaster) == false || InCaster->IsPlayingSkill(m_ProjectileInfo.SkillCID) == false))
-				{
-					// 발사 시점에 해당 스킬이 캔슬된 경우 발사체를 발사하지 않음.
-					bActive = false;
-					return;
-				}
-
-				if (SkeletalMeshComponent) SkeletalMeshComponent->SetVisibility(true);
-				if (PointLightComponent) PointLightComponent->SetVisibility(true);
-				if (ParticleSystemComponent) ParticleSystemComponent->Activate();
-				if (AudioComponents.Num() > 0) ActiveAudioComponents();
-				if (ProjectileMovementComponent) ProjectileMovementComponent->Activate(); // Projectile
-
-				PreElemTM.AddDefaulted(1);
-				PreElemTM[0] = StartElemTM;
+				TickFixedStep(DeltaTime);
 			}
-
-			if (HasAuthority() == true)
+			else if (HasAuthority() == true)
 			{
 				CheckSweep();
 			}
@@ -84,62 +116,235 @@ void ACustomProjectileActor::Tick(float DeltaTime)
 	ElapsedTime += DeltaTime;
 }
 
-void ACustomProjectileActor::Fire(FSkillProjectileInfo InProjectileInfo)
+void ACustomProjectileActor::Ignite()
+{
+	ElapsedTime = FMath::Max(ElapsedTime, ShotInfo.FireDelay);
+
+	const FName SkillCID = Archetype->GetProjectileInfo().SkillCID;
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(ShotInfo.Caster.Get());
+	if (SkillCID != NAME_None && (IsValid(InCaster) == false || (ShotInfo.bSimulated == false && InCaster->IsPlayingSkill(SkillCID) == false)))	// 대역은 스킬을 재생하지 않는다.
+	{
+		// 발사 시점에 해당 스킬이 캔슬된 경우 발사체를 발사하지 않음.
+		// (CancelScheduledProjectiles 알림을 받지 못한 경우를 위한 마지막 확인)
+		bActive = false;
+		return;
+	}
+
+#if !UE_SERVER
+	if (SkeletalMeshComponent) SkeletalMeshComponent->SetVisibility(true);
+	if (PointLightComponent) RegisterLight();
+	if (ParticleSystemComponent) ParticleSystemComponent->Activate(true);	// 풀에서 재사용한 트레일이 이전 상태를 갖고 있지 않도록
+	if (AudioComponents.Num() > 0) ActiveAudioComponents();
+	RegisterSignificance();
+#endif
+
+	// Projectile
+	if (FixedStep.bEnabled == true)
+	{
+		FixedStep.LaunchLocation = GetActorLocation();
+		FixedStep.LaunchVelocity = ProjectileMovementComponent->Velocity;
+		FixedStep.Gravity = FVector(0.f, 0.f, GetWorld()->GetGravityZ() * ProjectileMovementComponent->ProjectileGravityScale);
+	}
+	else if (ProjectileMovementComponent)
+	{
+		ProjectileMovementComponent->Activate();
+	}
+
+	PreElemTM.AddDefaulted(1);
+	PreElemTM[0] = StartElemTM;
+}
+
+void ACustomProjectileActor::TickFixedStep(const float InDeltaTime)
+{
+	const float StepTime = 1.f / FMath::Max(CVarProjectileFixedStepHz.GetValueOnGameThread(), 1.f);
+	const int MaxSubSteps = FMath::Max(CVarProjectileFixedStepMaxSubSteps.GetValueOnGameThread(), 1);
+
+	// 예산을 넘는 시간은 버린다. (서버 프레임이 크게 밀린 경우)
+	FixedStep.Accumulator = FMath::Min(FixedStep.Accumulator + InDeltaTime, StepTime * MaxSubSteps);
+
+	const bool bCheckHit = HasAuthority();
+	const FTransform CollisionRelativeTM = IsValid(CollisionComponent) ? CollisionComponent->GetRelativeTransform() : FTransform::Identity;
+	const float MaxMoveDistance = Archetype->GetMaxMoveDistance();
+
+	// 위치는 항상 발사 시점부터의 스텝 수로 계산하므로 서버 프레임레이트와 무관하다.
+	while (FixedStep.Accumulator >= StepTime && bActive == true)
+	{
+		const float PrevTime = FixedStep.StepIndex * StepTime;
+		const float NextTime = (FixedStep.StepIndex + 1) * StepTime;
+
+		const FVector PrevLocation = FixedStep.GetLocation(PrevTime);
+		FVector NextLocation = FixedStep.GetLocation(NextTime);
+		const FVector StepVelocity = FixedStep.GetVelocity(NextTime);
+
+		// 경로 길이로 최대 이동거리 제한 (포물선도 EndElemTM 을 지나치지 않도록)
+		bool bReachedEnd = false;
+		const float StepDistance = FVector::Dist(PrevLocation, NextLocation);
+		if (FixedStep.MovedDistance + StepDistance >= MaxMoveDistance)
+		{
+			const float RemainDistance = FMath::Max(MaxMoveDistance - FixedStep.MovedDistance, 0.f);
+			NextLocation = PrevLocation + (NextLocation - PrevLocation).GetSafeNormal() * RemainDistance;
+			bReachedEnd = true;
+		}
+
+		if (bCheckHit == true)
+		{
+			const FQuat PrevRot = FixedStep.GetVelocity(PrevTime).ToOrientationQuat();
+			const FQuat NextRot = StepVelocity.ToOrientationQuat();
+			const FVector SweepStart = (CollisionRelativeTM * FTransform(PrevRot, PrevLocation)).GetLocation();
+			const FVector SweepEnd = (CollisionRelativeTM * FTransform(NextRot, NextLocation)).GetLocation();
+
+			SweepSegment(SweepStart, SweepEnd, StepVelocity);
+		}
+
+		ProjectileMovementComponent->Velocity = StepVelocity;
+		FixedStep.MovedDistance += FVector::Dist(PrevLocation, NextLocation);
+		FixedStep.Accumulator -= StepTime;
+		FixedStep.StepIndex++;
+
+		if (bReachedEnd == true)
+		{
+			SetActorLocation(NextLocation);
+			bActive = false;
+			return;
+		}
+	}
+
+	// 표시용 위치는 스텝 사이를 보간 (판정에는 사용하지 않음)
+	const float RenderTime = FixedStep.StepIndex * StepTime + FixedStep.Accumulator;
+	SetActorLocationAndRotation(FixedStep.GetLocation(RenderTime), FixedStep.GetVelocity(RenderTime).ToOrientationQuat());
+}
+
+void ACustomProjectileActor::OnScheduledFire()
+{
+	if (bActive == false)
+	{
+		return;
+	}
+
+	Ignite();
+	SetActorTickEnabled(true);
+}
+
+void ACustomProjectileActor::OnScheduledCancel()
+{
+	bActive = false;
+	Destroy();
+}
+
+void ACustomProjectileActor::Fire(const FSkillProjectileInfo& InProjectileInfo)
 {
 	ACustomCharacter* InCaster = Cast<ACustomCharacter>(InProjectileInfo.Caster);
-	if (IsValid(InCaster) == false || IsValid(ProjectileMovementComponent) == false || FinalProjectileLifetime <= 0.f)
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (IsValid(InCaster) == false || ProjectileSubsystem == nullptr)
 	{
 		bActive = false;
 		return;
 	}
 
+	// 게이지 검사가 들어있으므로 한 번만
+	ICombatHitPolicy* HitPolicy = ProjectileSubsystem->GetHitPolicy();
+	const bool bPierceable = ProjectileSubsystem->IsSimulatedCaster(InCaster) ? HitPolicy->CalcPierceable(InCaster, InProjectileInfo) : CalcPierceable(InCaster, InProjectileInfo);
+
+	if (HitPolicy != nullptr)
+	{
+		FProjectileVolleyPattern InPattern;
+		HitPolicy->OnProjectileFire(GetClass(), GetActorTransform(), InProjectileInfo, InPattern, bPierceable);
+	}
+
+	UProjectileArchetype* InArchetype = ProjectileSubsystem->FindOrCompileArchetype(InProjectileInfo);
+	if (ProjectileSubsystem->CanFireAsHitscan(InArchetype, InProjectileInfo))
+	{
+		// 이미 스폰된 경우에도 컴포넌트 생성 없이 히트스캔으로 처리하고 바로 제거
+		ProjectileSubsystem->FireHitscan(InArchetype, InProjectileInfo, GetActorLocation(), bPierceable, HasAuthority(), nullptr);
+		bActive = false;
+		Destroy();
+		return;
+	}
+
+	if (Launch(InArchetype, InProjectileInfo, bPierceable, nullptr) == false)
+	{
+		return;
+	}
+
+	InCaster->GetValidProjectileCountBySkill().FindOrAdd(InProjectileInfo.SkillCID)++;
+}
+
+bool ACustomProjectileActor::Launch(UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const bool bInPierceable, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor)
+{
+	Archetype = InArchetype;
+	if (IsValid(Archetype) == false || IsValid(ProjectileMovementComponent) == false)
+	{
+		bActive = false;
+		return false;
+	}
+
 	// LifeTime
-	const float InMaxDistance = InProjectileInfo.ProjectileMaxMoveDistance - InProjectileInfo.CollisionExtent.X;
-	const float BaseLifeSpan = InProjectileInfo.UseLifeTime ? InProjectileInfo.InitialLifeSpan + InProjectileInfo.FireDelay: 0.f;
-	const float LifeTimeByDist = (InMaxDistance / InProjectileInfo.ProjectileSpeed) + InProjectileInfo.FireDelay;
-	const float FinalProjectileLifetime = LifeTimeByDist <= 0.f ? BaseLifeSpan : LifeTimeByDist; // MaxDistance가 BaseLifeSpan보다 우선순위가 높다.
+	const float FinalProjectileLifetime = Archetype->GetLifeSpan(InProjectileInfo.FireDelay);
+	if (FinalProjectileLifetime <= 0.f)
+	{
+		bActive = false;
+		return false;
+	}
 
 	SetLifeSpan(FinalProjectileLifetime);
 
+	ShotInfo.Caster = InProjectileInfo.Caster;
+	ShotInfo.Target = InProjectileInfo.Target;
+	ShotInfo.FireDelay = InProjectileInfo.FireDelay;
+	ShotInfo.bPierceableChar = bInPierceable;
+
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	ShotInfo.bSimulated = ProjectileSubsystem != nullptr && ProjectileSubsystem->IsSimulatedCaster(InProjectileInfo.Caster);
+
+	FixedStep = FProjectileFixedStepState();
+	FixedStep.bEnabled = bUseFixedStepIntegration || CVarProjectileFixedStepForce.GetValueOnGameThread() != 0;
+
+	SharedHittedActor = InSharedHittedActor;
+
 	// Projectile
 	{
 		ProjectileMovementComponent->InitialSpeed = InProjectileInfo.ProjectileSpeed;
 		ProjectileMovementComponent->MaxSpeed = InProjectileInfo.ProjectileSpeed;
-		ProjectileMovementComponent->Velocity = CalcMoveDir(InProjectileInfo) * InProjectileInfo.ProjectileSpeed;
+		ProjectileMovementComponent->Velocity = CalcMoveDir(GetWorld(), InProjectileInfo, GetActorLocation()) * InProjectileInfo.ProjectileSpeed;
 		ProjectileMovementComponent->ProjectileGravityScale = InProjectileInfo.ProjectileGravityScale;
 		ProjectileMovementComponent->SetUpdatedComponent(RootComponent);
 	}
 
-	CollisionComponent = CreateCollision(InProjectileInfo);		// Collision
-	SkeletalMeshComponent = CreateMesh(InProjectileInfo);		// Mesh
-	PointLightComponent = CreateLight(InProjectileInfo);		// Light
-	ParticleSystemComponent = CreateParticle(InProjectileInfo);	// Particle
-	AudioComponents = CreateSound(InProjectileInfo);			// Audio
+	CollisionComponent = CreateCollision();			// Collision
+#if !UE_SERVER
+	SkeletalMeshComponent = CreateMesh();			// Mesh
+	PointLightComponent = CreateLight();			// Light
+	ParticleSystemComponent = CreateParticle();		// Particle
+	AudioComponents = CreateSound();				// Audio
+#endif
 
 	// 초기 위치 설정
 	const FVector InDir = ProjectileMovementComponent->Velocity.GetSafeNormal();
-	const FVector InStartLoc = InProjectileInfo.Caster->GetActorLocation();
 	StartElemTM = FTransform(GetActorLocation());
-	EndElemTM = FTransform(StartElemTM.GetLocation() + (InDir * InMaxDistance));
+	EndElemTM = FTransform(StartElemTM.GetLocation() + (InDir * Archetype->GetMaxMoveDistance()));
 
-	m_ProjectileInfo = InProjectileInfo;
+	SetOwner(InProjectileInfo.Caster);
 
-	m_ProjectileInfo.ProjectileMaxMoveDistance = InMaxDistance;
+	// 발사 지연 동안은 틱을 끄고 예약 목록에서 대기
+	if (ShotInfo.FireDelay > 0.f && ProjectileSubsystem != nullptr)
+	{
+		SetActorTickEnabled(false);
+		ProjectileSubsystem->ScheduleProjectile(this, Archetype->GetProjectileInfo().SkillCID, ShotInfo.FireDelay);
+	}
 
+	return true;
+}
+
+bool ACustomProjectileActor::CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo)
+{
 	// 관통 가능여부 재설정
 	const bool IsPierceableSection = InCaster->GetSkillSectionInfo().CheckFlags(ESkillSectionInfoBitflags::ProjectilePierceable);
-	const bool bPierceable = InProjectileInfo.bForcePierceableChar || (IsPierceableSection == true && MyUtility::HasEnoughActionGauge(InCaster, InProjectileInfo.SkillCID, true));
-	m_ProjectileInfo.bForcePierceableChar = bPierceable;
-
-	InCaster->GetValidProjectileCountBySkill().FindOrAdd(m_ProjectileInfo.SkillCID)++;
-
-	SetOwner(InCaster);
+	return InProjectileInfo.bForcePierceableChar || (IsPierceableSection == true && MyUtility::HasEnoughActionGauge(InCaster, InProjectileInfo.SkillCID, true));
 }
 
 void ACustomProjectileActor::CheckSweep()
 {
-	ACustomCharacter* InCaster = Cast<ACustomCharacter>(m_ProjectileInfo.Caster);
-	if (IsValid(InCaster) == false || CollisionComponent == nullptr)
+	if (CollisionComponent == nullptr)
 	{
 		bActive = false;
 		return;
@@ -147,42 +352,62 @@ void ACustomProjectileActor::CheckSweep()
 
 	FTransform InCurElemTM = CollisionComponent->GetComponentTransform();
 	const float InMoveDist = FVector::Dist(InCurElemTM.GetLocation(),StartElemTM.GetLocation());
-	if (InMoveDist > m_ProjectileInfo.ProjectileMaxMoveDistance) InCurElemTM = EndElemTM;
+	if (InMoveDist > Archetype->GetMaxMoveDistance()) InCurElemTM = EndElemTM;
+
+	SweepSegment(PreElemTM[0].GetLocation(), InCurElemTM.GetLocation(), ProjectileMovementComponent->Velocity);
+
+	PreElemTM[0] = InCurElemTM;
+}
+
+void ACustomProjectileActor::SweepSegment(const FVector& InStart, const FVector& InEnd, const FVector& InVelocity)
+{
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(ShotInfo.Caster.Get());
+	if (IsValid(InCaster) == false || CollisionComponent == nullptr)
+	{
+		bActive = false;
+		return;
+	}
 
 	// SweepCheck
 	TArray<struct FHitResult> OutHits;
 	{
-		FCollisionShape InCollisionShape;
-
-		FQuat InSweepQuat = ProjectileMovementComponent->Velocity.GetSafeNormal2D().ToOrientationQuat();
-
-		if (m_ProjectileInfo.CollisionShape == ECollisionSweepShapeType::Shpere)
-		{
-			InCollisionShape = FCollisionShape::MakeSphere(m_ProjectileInfo.CollisionExtent.X);
-		}
-		else if (m_ProjectileInfo.CollisionShape == ECollisionSweepShapeType::Box)
-		{
-			InCollisionShape = FCollisionShape::MakeBox(m_ProjectileInfo.CollisionExtent);
-		}
-		else if (m_ProjectileInfo.CollisionShape == ECollisionSweepShapeType::Capsule)
-		{
-			InCollisionShape = FCollisionShape::MakeCapsule(m_ProjectileInfo.CollisionExtent.Y, m_ProjectileInfo.CollisionExtent.X);
-			InSweepQuat *= FQuat(FRotator(90.f, 0.f, 0.f));
-		}
+		const FCollisionShape& InCollisionShape = Archetype->GetSweepShape();
+		const FQuat InSweepQuat = InVelocity.GetSafeNormal2D().ToOrientationQuat() * Archetype->GetSweepShapeRotation();
 
 		FCollisionQueryParams InCollParams = FCollisionQueryParams();
 		InCollParams.AddIgnoredActor(InCaster);
 		InCollParams.AddIgnoredActor(this);
-		InCollParams.AddIgnoredActors(HittedActor.Array());
+		InCollParams.AddIgnoredActors(GetHittedActor().Array());
 
-		GetWorld()->SweepMultiByChannel(OutHits, PreElemTM[0].GetLocation(), InCurElemTM.GetLocation(), InSweepQuat, ECollisionChannel::ECC_GameTraceChannel12, InCollisionShape, InCollParams);
+		COMBAT_PERF_SCOPE(ProjectileSweep);
+		GetWorld()->SweepMultiByChannel(OutHits, InStart, InEnd, InSweepQuat, ECollisionChannel::ECC_GameTraceChannel12, InCollisionShape, InCollParams);
+
+		UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+		if (ProjectileSubsystem != nullptr)
+		{
+			ProjectileSubsystem->ApplyLagCompensation(InCaster, InStart, InEnd, InCollisionShape, GetHittedActor(), OutHits);
+		}
 	}
 
 	// Operate
-	bool bShowDebugOnHit = false;
-	for (int InCollIndex = 0; InCollIndex < OutHits.Num(); InCollIndex++)
+	const int StopIndex = ProcessSweepHits(InCaster, ShotInfo.bSimulated, OutHits, ShotInfo.bPierceableChar, Archetype->GetProjectileInfo().bForcePierceableObject,
+		[this](const FHitResult& InHitResult) { OnHit(InHitResult); });
+
+	if (StopIndex != INDEX_NONE)
 	{
-		const FHitResult& InHitResult = OutHits[InCollIndex];
+		bActive = false;
+	}
+}
+
+int ACustomProjectileActor::ProcessSweepHits(ACustomCharacter* InCaster, const bool bInSimulated, const TArray<FHitResult>& InHits, const bool bInPierceableChar, const bool bInPierceableObject, TFunctionRef<void(const FHitResult&)> InOnHit)
+{
+	COMBAT_PERF_SCOPE(HitProcessing);
+
+	ICombatHitPolicy* HitPolicy = UProjectileSubsystem::GetHitPolicy(InCaster->GetWorld());
+
+	for (int InCollIndex = 0; InCollIndex < InHits.Num(); InCollIndex++)
+	{
+		const FHitResult& InHitResult = InHits[InCollIndex];
 		if (InHitResult.bBlockingHit == false)
 		{
 			continue;
@@ -194,169 +419,229 @@ void ACustomProjectileActor::CheckSweep()
 			continue;
 		}
 
-		if (MyUtility::CanAttack(InCaster, TargetActor))
+		if (CheckAttackable(HitPolicy, bInSimulated, InCaster, TargetActor))
 		{
-			OnHit(InHitResult);
+			InOnHit(InHitResult);
 		}
 		else
 		{
 			// 공격 불가능한 대상..
 		}
 
-		bShowDebugOnHit = true;
-
 		const bool bIsCharacterTarget = TargetActor->IsA<ACustomCharacter>();
-		if ((bIsCharacterTarget == true && m_ProjectileInfo.bForcePierceableChar == false) ||
-			(bIsCharacterTarget == false && m_ProjectileInfo.bForcePierceableObject == false))
+		if ((bIsCharacterTarget == true && bInPierceableChar == false) ||
+			(bIsCharacterTarget == false && bInPierceableObject == false))
 		{
-			bActive = false;
-			break;
+			return InCollIndex;
 		}
 	}
 
-	PreElemTM[0] = InCurElemTM;
+	return INDEX_NONE;
 }
 
 void ACustomProjectileActor::OnHit(const FHitResult& InHitResult)
 {
-	ACustomCharacter* InCaster = Cast<ACustomCharacter>(m_ProjectileInfo.Caster);
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(ShotInfo.Caster.Get());
 	if (IsValid(InCaster) == false || CollisionComponent == nullptr)
 	{
 		return;
 	}
 
-	ACustomPlayerState* InCasterState = MyUtility::GetCustomPlayerState(InCaster);
-	if (IsValid(InCasterState) == false)
+	const FSkillProjectileInfo& InProjectileInfo = Archetype->GetProjectileInfo();
+
+	AActor* HitActor = InHitResult.GetActor();
+	if (SendHit(InCaster, ShotInfo.bSimulated, InProjectileInfo, StartElemTM.GetLocation(), InHitResult) == false)
 	{
 		return;
 	}
 
-	AActor* HitActor = InHitResult.GetActor();
+	GetHittedActor().Emplace(HitActor);
+
+#if !UE_SERVER
 	ACustomCharacter* HitCharacter = Cast<ACustomCharacter>(HitActor);
-	UPrimitiveComponent* HitComp = InHitResult.GetComponent();
+	USkeletalMeshComponent* HitAttachParentComp = IsValid(HitCharacter) ? HitCharacter->GetBodyMesh() : nullptr;
+	UParticleSystem* HitParticle = ShotInfo.bPierceableChar ? nullptr : InProjectileInfo.AttachParticleOnHit;
+
+	if (IsValid(HitAttachParentComp) && HitParticle != nullptr)
+	{
+		if (MyUtility::IsInDedicatedServer(GetWorld()) == true)
+		{
+			return;
+		}
+		else
+		{
+			if (IsValid(ParticleSystemComponent)) DeActiveParticleComponent();
+			if (IsValid(PointLightComponent)) UnregisterLight();
+			if (AudioComponents.Num() > 0) DeActiveAudioComponents();
+
+			// 끈 시각 효과를 중요도 변경이 다시 켜지 않도록
+			UCombatSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCombatSignificanceSubsystem>();
+			if (SignificanceSubsystem) SignificanceSubsystem->Unregister(this);
+
+			SpawnHitAttachParticle(GetWorld(), HitParticle, HitCharacter, InProjectileInfo.TargetBoneNames, InHitResult.ImpactPoint, ProjectileMovementComponent->Velocity);
+		}
+	}
+#endif
+}
+
+bool ACustomProjectileActor::CheckAttackable(ICombatHitPolicy* InHitPolicy, const bool bInSimulated, ACustomCharacter* InCaster, AActor* InTarget)
+{
+	const bool bCanAttack = bInSimulated ? InHitPolicy->CanAttack(InCaster, InTarget) : MyUtility::CanAttack(InCaster, InTarget);
+	if (InHitPolicy != nullptr)
+	{
+		InHitPolicy->OnHit(ECombatHitKind::Projectile, InCaster, InTarget, bCanAttack);
+	}
 
-	HittedActor.Emplace(HitActor);
+	return bCanAttack;
+}
+
+bool ACustomProjectileActor::SendHit(ACustomCharacter* InCaster, const bool bInSimulated, const FSkillProjectileInfo& InProjectileInfo, const FVector& InOrigin, const FHitResult& InHitResult)
+{
+	// 대역의 히트는 판정만 재고 데미지는 보내지 않는다.
+	if (bInSimulated == true)
+	{
+		return true;
+	}
 
-	USkeletalMeshComponent* HitAttachParentComp = nullptr;
+	ACustomPlayerState* InCasterState = MyUtility::GetCustomPlayerState(InCaster);
+	if (IsValid(InCasterState) == false)
+	{
+		return false;
+	}
 
+	ACustomCharacter* HitCharacter = Cast<ACustomCharacter>(InHitResult.GetActor());
 	if (IsValid(HitCharacter))
 	{
-		const EHitForceType HitForceType = MyUtility::GetHitForceType(InCaster, m_ProjectileInfo.SkillCID, m_ProjectileInfo.AttackDamageIndex);
-		const EHitDirType HitDirType = MyUtility::GetHitDirType(StartElemTM.GetLocation(), HitCharacter);
+		const EHitForceType HitForceType = MyUtility::GetHitForceType(InCaster, InProjectileInfo.SkillCID, InProjectileInfo.AttackDamageIndex);
+		const EHitDirType HitDirType = MyUtility::GetHitDirType(InOrigin, HitCharacter);
 
 		InCasterState->OnSend_Hit_Skill(
 			HitCharacter,
-			m_ProjectileInfo.SkillCID.ToString(),
+			InProjectileInfo.SkillCID.ToString(),
 			ESkillType::SkillType_Exec_0,
 			HitDirType,
 			InHitResult.BoneName.ToString(),
 			InHitResult.ImpactPoint,
 			InHitResult.ImpactNormal,
 			ESkillDamageType::ESkillDamage_Normal,
-			m_ProjectileInfo.AttackDamageIndex
+			InProjectileInfo.AttackDamageIndex
 		);
+	}
+
+	return true;
+}
 
-		HitAttachParentComp = HitCharacter->GetBodyMesh();
+void ACustomProjectileActor::SpawnHitAttachParticle(UWorld* InWorld, UParticleSystem* InHitParticle, ACustomCharacter* InHitCharacter, const TArray<FName>& InTargetBoneNames, const FVector& InImpactPoint, const FVector& InVelocity)
+{
+	USkeletalMeshComponent* HitAttachParentComp = IsValid(InHitCharacter) ? InHitCharacter->GetBodyMesh() : nullptr;
+	UProjectileSubsystem* ProjectileSubsystem = InWorld->GetSubsystem<UProjectileSubsystem>();
+	if (IsValid(HitAttachParentComp) == false || InHitParticle == nullptr || ProjectileSubsystem == nullptr)
+	{
+		return;
 	}
 
-	UParticleSystem* HitParticle = m_ProjectileInfo.bForcePierceableChar ? nullptr : m_ProjectileInfo.AttachParticleOnHit;
+	// 가장 가까운 소켓 찾기.
+	FName TargetSocketName = NAME_None;
+	FTransform Transform;
+	ProjectileSubsystem->GetSocketCache().FindClosestSocket(HitAttachParentComp, InTargetBoneNames, InImpactPoint, TargetSocketName, Transform);
 
-	if (IsValid(HitAttachParentComp) && HitParticle != nullptr)
+	if (TargetSocketName != NAME_None)
 	{
-		if (MyUtility::IsInDedicatedServer(GetWorld()) == true)
+		UParticleSystemComponent* Particle = UGameplayStatics::SpawnEmitterAtLocation(InWorld, InHitParticle, Transform, true, EPSCPoolMethod::None, false);
+		if (Particle == nullptr)
 		{
 			return;
 		}
-		else
-		{
-			if (IsValid(ParticleSystemComponent)) DeActiveParticleComponent();
-			if (IsValid(PointLightComponent)) PointLightComponent->Deactivate();
-			if (AudioComponents.Num() > 0) DeActiveAudioComponents();
 
-			// 가장 가까운 소켓 찾기.
-			FName TargetSocketName = NAME_None;
-			float MinDistance = 0.f;
+		if (InHitCharacter == MyUtility::GetCustomPlayerCharacter(InWorld)) Particle->SetCustomPrimitiveDataFloat(0, 1);
+		else Particle->SetCustomPrimitiveDataFloat(0, 0);
 
-			for (const FName& AttachSocketName : m_ProjectileInfo.TargetBoneNames)
-			{
-				const float DistToSocket = (HitAttachParentComp->GetSocketLocation(AttachSocketName) - InHitResult.ImpactPoint).Size();
-				if (TargetSocketName == NAME_None || DistToSocket < MinDistance)
-				{
-					TargetSocketName = AttachSocketName;
-					MinDistance = DistToSocket;
-				}
-			}
+		Particle->SetUsingAbsoluteLocation(false);
+		Particle->SetUsingAbsoluteScale(false);
+		Particle->bAutoManageAttachment = true;
 
-			if (TargetSocketName != NAME_None)
-			{
-				FTransform Transform = HitAttachParentComp->GetSocketTransform(TargetSocketName);
-				UParticleSystemComponent* Particle = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), HitParticle, Transform, true, EPSCPoolMethod::None, false);
-				
-				if (Particle != nullptr)
-				{
-					if (HitCharacter != nullptr && HitCharacter == MyUtility::GetCustomPlayerCharacter(GetWorld())) Particle->SetCustomPrimitiveDataFloat(0, 1);
-					else Particle->SetCustomPrimitiveDataFloat(0, 0);
-				}
-
-				Particle->SetUsingAbsoluteLocation(false);
-				Particle->SetUsingAbsoluteScale(false);
-				Particle->bAutoManageAttachment = true;
-
-				FQuat Rot = ProjectileMovementComponent->Velocity.GetSafeNormal2D().ToOrientationQuat() * FQuat(FRotator(0.f, 90.f, 0.f));
-				Particle->SetWorldRotation(Rot);
-				Particle->SetAutoAttachmentParameters(HitAttachParentComp, TargetSocketName, EAttachmentRule::SnapToTarget, EAttachmentRule::KeepRelative, EAttachmentRule::SnapToTarget);
-				Particle->ActivateSystem(true);
-
-				if (IsValid(HitCharacter))
-				{
-					HitCharacter->AddHitParticle(Particle);
-				}
-			}
-		}
+		FQuat Rot = InVelocity.GetSafeNormal2D().ToOrientationQuat() * FQuat(FRotator(0.f, 90.f, 0.f));
+		Particle->SetWorldRotation(Rot);
+		Particle->SetAutoAttachmentParameters(HitAttachParentComp, TargetSocketName, EAttachmentRule::SnapToTarget, EAttachmentRule::KeepRelative, EAttachmentRule::SnapToTarget);
+		Particle->ActivateSystem(true);
+
+		InHitCharacter->AddHitParticle(Particle);
 	}
 }
 
 
 void ACustomProjectileActor::OnDestroy()
 {
+#if !UE_SERVER
 	DeActiveParticleComponent(); 
 	DeActiveAudioComponents();
+#endif
 }
 
+#if !UE_SERVER
 void ACustomProjectileActor::DeActiveParticleComponent()
 {
-	if (IsValid(ParticleSystemComponent))
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (IsValid(ParticleSystemComponent) && IsValid(Archetype) && ProjectileSubsystem != nullptr)
 	{
-		if (m_ProjectileInfo.bDestroyParticleComponentOnHit == false)
+		// 트레일은 풀로 넘기고, 남은 파티클 재생이 끝나면 다음 발사체가 재사용한다.
+		if (Archetype->GetProjectileInfo().bDestroyParticleComponentOnHit == false)
 		{
-			for (const FName EmitterName : m_ProjectileInfo.EmitterNameToDisableOnHit)
-			{
-				for (int Index = 0; Index < ParticleSystemComponent->EmitterInstances.Num(); Index++)
-				{
-					if (ParticleSystemComponent->EmitterInstances[Index] != nullptr)
-					{
-						UParticleEmitter* ParticleEmitter = ParticleSystemComponent->EmitterInstances[Index]->SpriteTemplate;
-						if (IsValid(ParticleEmitter) && ParticleEmitter->EmitterName == EmitterName)
-						{
-							ParticleSystemComponent->EmitterInstances[Index]->bEnabled = false;
-						}
-					}
-				}
-			}
-
-			ParticleSystemComponent->Deactivate();
-			ParticleSystemComponent->bAutoDestroy = true;
-			ParticleSystemComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			ProjectileSubsystem->GetTrailPool()->ReleaseDeferred(ParticleSystemComponent, Archetype->GetEmitterIndicesToDisableOnHit());
 		}
 		else
 		{
-			ParticleSystemComponent->DestroyComponent();
+			ProjectileSubsystem->GetTrailPool()->ReleaseImmediate(ParticleSystemComponent);
 		}
 	}
+	else if (IsValid(ParticleSystemComponent))
+	{
+		// 풀로 돌리지 못하면 월드가 오너인 컴포넌트가 남지 않도록 제거
+		ParticleSystemComponent->DestroyComponent();
+	}
+
+	ParticleSystemComponent = nullptr;
+}
+
+void ACustomProjectileActor::RegisterLight()
+{
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (ProjectileSubsystem == nullptr || IsValid(PointLightComponent) == false || IsValid(Archetype) == false)
+	{
+		return;
+	}
+
+	// 켜고 끄는 것은 라이트 매니저가 예산에 따라 처리
+	const FSkillProjectileInfo& InProjectileInfo = Archetype->GetProjectileInfo();
+	ProjectileSubsystem->GetLightManager().Register(PointLightComponent, InProjectileInfo.Insensity, InProjectileInfo.CastShadow);
+}
+
+void ACustomProjectileActor::UnregisterLight()
+{
+	if (IsValid(PointLightComponent) == false)
+	{
+		return;
+	}
+
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UProjectileSubsystem>() : nullptr;
+	if (ProjectileSubsystem)
+	{
+		ProjectileSubsystem->GetLightManager().Unregister(PointLightComponent);
+	}
+
+	PointLightComponent->Deactivate();
+	PointLightComponent->SetVisibility(false);
 }
 
 void ACustomProjectileActor::ActiveAudioComponents()
 {
+	if (IsValid(Archetype) == false)
+	{
+		return;
+	}
+
+	const TArray<FSoundInfo>& SoundInfos = Archetype->GetProjectileInfo().SoundInfo;
+
 	for (int Index = 0; Index < AudioComponents.Num(); Index++)
 	{
 		if (AudioComponents[Index].IsValid() && SoundInfos.IsValidIndex(Index))
@@ -373,6 +658,9 @@ void ACustomProjectileActor::ActiveAudioComponents()
 
 void ACustomProjectileActor::DeActiveAudioComponents()
 {
+	static const TArray<FSoundInfo> EmptySoundInfos;
+	const TArray<FSoundInfo>& SoundInfos = IsValid(Archetype) ? Archetype->GetProjectileInfo().SoundInfo : EmptySoundInfos;
+
 	for (int Index = 0; Index < AudioComponents.Num(); Index++)
 	{
 		bool bDestroyImmediately = true;
@@ -401,19 +689,17 @@ void ACustomProjectileActor::DeActiveAudioComponents()
 	}
 }
 
-UCustomSkeletalMeshComponent* ACustomProjectileActor::CreateMesh(const FSkillProjectileInfo& InProjectileInfo)
+UCustomSkeletalMeshComponent* ACustomProjectileActor::CreateMesh()
 {
-	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || IsValid(InProjectileInfo.Caster) == false || InProjectileInfo.ProjectileSkeletalMesh == nullptr)
+	UCustomSkeletalMeshComponent* MeshTemplate = Archetype->GetMeshTemplate();
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || MeshTemplate == nullptr)
 	{
 		return nullptr;
 	}
 
-	UCustomSkeletalMeshComponent* pComponent = NewObject<UCustomSkeletalMeshComponent>(this);
+	UCustomSkeletalMeshComponent* pComponent = NewObject<UCustomSkeletalMeshComponent>(this, NAME_None, RF_NoFlags, MeshTemplate);
 	if (pComponent)
 	{
-		pComponent->SetVisibility(false);
-		pComponent->SetSkeletalMesh(InProjectileInfo.ProjectileSkeletalMesh);
-		pComponent->SetRelativeTransform(InProjectileInfo.ProjectileSkeletalMeshTM);
 		pComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 		pComponent->RegisterComponent();
 	}
@@ -421,89 +707,36 @@ UCustomSkeletalMeshComponent* ACustomProjectileActor::CreateMesh(const FSkillPro
 	return pComponent;
 }
 
-UCustomParticleSystemComponent* ACustomProjectileActor::CreateParticle(const FSkillProjectileInfo& InProjectileInfo)
+UCustomParticleSystemComponent* ACustomProjectileActor::CreateParticle()
 {
-	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || IsValid(InProjectileInfo.Caster) == false || InProjectileInfo.ProjectileParticle == nullptr)
+	UCustomParticleSystemComponent* ParticleTemplate = Archetype->GetParticleTemplate();
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || ParticleTemplate == nullptr || ProjectileSubsystem == nullptr)
 	{
 		return nullptr;
 	}
 	
-	//Projectile이 Destroy되도 Trail은 남아야하기 때문에 월드를 오너로 세팅
-	UCustomParticleSystemComponent* OutParticle = NewObject<UCustomParticleSystemComponent>(GetWorld());
+	//Projectile이 Destroy되도 Trail은 남아야하기 때문에 풀에서 월드를 오너로 만든 컴포넌트를 받는다.
+	UCustomParticleSystemComponent* OutParticle = ProjectileSubsystem->GetTrailPool()->Acquire(GetWorld(), ParticleTemplate, Archetype->GetEmitterIndicesToDisableOnHit());
 	if (OutParticle)
 	{
-		OutParticle->RegisterComponentWithWorld(GetWorld());
-		OutParticle->bAutoActivate = false;
-		OutParticle->bNeverDistanceCull = true;
-		OutParticle->SetTemplate(InProjectileInfo.ProjectileParticle);
 		OutParticle->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-		OutParticle->SetRelativeTransform(InProjectileInfo.ProjectileParticleTM);
 	}
 
 	return OutParticle;
 }
 
-UShapeComponent* ACustomProjectileActor::CreateCollision(const FSkillProjectileInfo& InProjectileInfo)
+UPointLightComponent* ACustomProjectileActor::CreateLight()
 {
-	UShapeComponent* InNewCollision = nullptr;
-
-	FRotator InCollisionRotate;
-
-	switch (InProjectileInfo.CollisionShape)
-	{
-	case ECollisionSweepShapeType::Box:
-	{
-		UBoxComponent* InNewBoxComp = NewObject<UBoxComponent>(this, UBoxComponent::StaticClass(), FName("CollisionComponent"));
-		if (IsValid(InNewBoxComp)) InNewBoxComp->SetBoxExtent(InProjectileInfo.CollisionExtent);
-		InNewCollision = InNewBoxComp;
-		break;
-	}
-	case ECollisionSweepShapeType::Capsule:
-	{
-		UCapsuleComponent* InNewCapsuleComp = NewObject<UCapsuleComponent>(this, UCapsuleComponent::StaticClass(), FName("CollisionComponent"));
-		if (IsValid(InNewCapsuleComp)) InNewCapsuleComp->SetCapsuleSize(InProjectileInfo.CollisionExtent.Z, FMath::Max(InProjectileInfo.CollisionExtent.X, InProjectileInfo.CollisionExtent.Y));
-		InNewCollision = InNewCapsuleComp;
-		break;
-	}
-	case ECollisionSweepShapeType::Shpere:
-	{
-		USphereComponent* InNewSphereComp = NewObject<USphereComponent>(this, USphereComponent::StaticClass(), FName("CollisionComponent"));
-		if (IsValid(InNewSphereComp)) InNewSphereComp->SetSphereRadius(FMath::Max(InProjectileInfo.CollisionExtent.X, InProjectileInfo.CollisionExtent.Y));
-		InNewCollision = InNewSphereComp;
-		break;
-	}
-	}
-
-	if (InNewCollision != nullptr)
-	{
-		InNewCollision->RegisterComponent();
-		InNewCollision->BodyInstance.SetCollisionProfileName(TEXT("Projectile"));
-		InNewCollision->bShouldCollideWhenPlacing = true;
-		InNewCollision->IgnoreActorWhenMoving(GetOwner(), true);
-		InNewCollision->IgnoreActorWhenMoving(this, true);
-		InNewCollision->SetRelativeTransform(InProjectileInfo.CollisionTM);
-		InNewCollision->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-	}
-
-	return InNewCollision;
-}
-
-UPointLightComponent* ACustomProjectileActor::CreateLight(const FSkillProjectileInfo& InProjectileInfo)
-{
-	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || IsValid(InProjectileInfo.Caster) == false || InProjectileInfo.UsePointLight == false)
+	UPointLightComponent* LightTemplate = Archetype->GetLightTemplate();
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || LightTemplate == nullptr)
 	{
 		return nullptr;
 	}
 
-	UPointLightComponent* OutLightComponent = NewObject<UPointLightComponent>(this);
+	UPointLightComponent* OutLightComponent = NewObject<UPointLightComponent>(this, NAME_None, RF_NoFlags, LightTemplate);
 	if (OutLightComponent)
 	{
-		OutLightComponent->SetVisibility(false);
-		OutLightComponent->SetMobility(EComponentMobility::Movable);
-		OutLightComponent->SetLightColor(InProjectileInfo.LightColor);
-		OutLightComponent->SetAttenuationRadius(InProjectileInfo.AttenuationRadius);
-		OutLightComponent->SetIntensity(InProjectileInfo.Insensity);
-		OutLightComponent->SetCastShadows(InProjectileInfo.CastShadow);
 		OutLightComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 		OutLightComponent->RegisterComponent();
 	}
@@ -511,35 +744,103 @@ UPointLightComponent* ACustomProjectileActor::CreateLight(const FSkillProjectile
 	return OutLightComponent;
 }
 
-TArray<TWeakObjectPtr<UAudioComponent>> ACustomProjectileActor::CreateSound(const FSkillProjectileInfo& InProjectileInfo)
+TArray<TWeakObjectPtr<UAudioComponent>> ACustomProjectileActor::CreateSound()
 {
 	TArray<TWeakObjectPtr<UAudioComponent>> Result;
 
-	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || IsValid(InProjectileInfo.Caster) == false || InProjectileInfo.SoundInfo.Num() == 0)
+	const TArray<UAudioComponent*>& SoundTemplates = Archetype->GetSoundTemplates();
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == true || SoundTemplates.Num() == 0)
 	{
 		return Result;
 	}
 
-	for (FSoundInfo SoundInfo : InProjectileInfo.SoundInfo)
+	for (UAudioComponent* SoundTemplate : SoundTemplates)
 	{
-		UAudioComponent* OutAudio = NewObject<UAudioComponent>(GetWorld());
+		UAudioComponent* OutAudio = SoundTemplate ? NewObject<UAudioComponent>(GetWorld(), NAME_None, RF_NoFlags, SoundTemplate) : nullptr;
 		if (OutAudio)
 		{
-			OutAudio->bAutoActivate = false;
-			OutAudio->SetSound(SoundInfo.SoundBase);
-			OutAudio->SetRelativeTransform(SoundInfo.SoundTM);
 			OutAudio->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 			OutAudio->RegisterComponentWithWorld(GetWorld());
-
-			Result.Add(OutAudio);
-			SoundInfos.Add(SoundInfo);
 		}
+
+		// SoundInfo 인덱스와 맞추기 위해 실패해도 자리를 채운다.
+		Result.Add(OutAudio);
 	}
 
 	return Result;
 }
 
-FVector ACustomProjectileActor::CalcMoveDir(const FSkillProjectileInfo& InProjectileInfo)
+void ACustomProjectileActor::RegisterSignificance()
+{
+	UCombatSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCombatSignificanceSubsystem>();
+	if (SignificanceSubsystem == nullptr)
+	{
+		return;
+	}
+
+	FCombatSignificanceDesc Desc;
+	Desc.Origin = RootComponent;
+	Desc.Instigator = ShotInfo.Caster;
+	Desc.Target = ShotInfo.Target;
+
+	ApplySignificance(SignificanceSubsystem->Register(this, Desc, FOnCombatSignificanceChanged::CreateUObject(this, &ACustomProjectileActor::ApplySignificance)));
+}
+
+void ACustomProjectileActor::ApplySignificance(const ECombatSignificance InSignificance)
+{
+	const bool bWasLightSuppressed = UCombatSignificanceSubsystem::ShouldSuppressLight(Significance);
+	const bool bLightSuppressed = UCombatSignificanceSubsystem::ShouldSuppressLight(InSignificance);
+	Significance = InSignificance;
+
+	// 판정 결과가 서버에서 확정되는 클라이언트에서만 틱을 줄인다.
+	if (GetNetMode() == NM_Client)
+	{
+		SetActorTickInterval(UCombatSignificanceSubsystem::GetTickInterval(InSignificance));
+	}
+
+	if (SkeletalMeshComponent) SkeletalMeshComponent->SetVisibility(InSignificance != ECombatSignificance::Culled);
+
+	UCombatSignificanceSubsystem::ApplyToParticle(ParticleSystemComponent, InSignificance);
+
+	if (bLightSuppressed == true && bWasLightSuppressed == false)
+	{
+		UnregisterLight();
+	}
+	else if (bLightSuppressed == false && bWasLightSuppressed == true && bActive == true && IsValid(PointLightComponent))
+	{
+		PointLightComponent->Activate();
+		RegisterLight();
+	}
+
+	for (const TWeakObjectPtr<UAudioComponent>& AudioComponent : AudioComponents)
+	{
+		UCombatSignificanceSubsystem::ApplyToAudio(AudioComponent.Get(), InSignificance);
+	}
+}
+
+#endif
+
+UShapeComponent* ACustomProjectileActor::CreateCollision()
+{
+	UShapeComponent* CollisionTemplate = Archetype->GetCollisionTemplate();
+	if (CollisionTemplate == nullptr)
+	{
+		return nullptr;
+	}
+
+	UShapeComponent* InNewCollision = NewObject<UShapeComponent>(this, CollisionTemplate->GetClass(), FName("CollisionComponent"), RF_NoFlags, CollisionTemplate);
+	if (InNewCollision != nullptr)
+	{
+		InNewCollision->RegisterComponent();
+		InNewCollision->IgnoreActorWhenMoving(GetOwner(), true);
+		InNewCollision->IgnoreActorWhenMoving(this, true);
+		InNewCollision->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	}
+
+	return InNewCollision;
+}
+
+FVector ACustomProjectileActor::CalcMoveDir(UWorld* InWorld, const FSkillProjectileInfo& InProjectileInfo, const FVector& InStartLocation)
 {
 	if (IsValid(InProjectileInfo.Caster) == false)
 	{
@@ -574,10 +875,16 @@ FVector ACustomProjectileActor::CalcMoveDir(const FSkillProjectileInfo& InProjec
 				HalfHeight = InCharacterTarget->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 			}
 
-			if (InAttachParentComp != nullptr)
+			UProjectileSubsystem* ProjectileSubsystem = InWorld->GetSubsystem<UProjectileSubsystem>();
+			if (InAttachParentComp != nullptr && ProjectileSubsystem != nullptr)
 			{
-				FVector InTargetSocketLoc = InAttachParentComp->GetSocketLocation(InProjectileInfo.TargetBoneNames[InRandIndex]);
-				ProjectileMoveDir = InTargetSocketLoc - GetActorLocation();
+				FSkeletalSocketCache& SocketCache = ProjectileSubsystem->GetSocketCache();
+				const TArray<FResolvedSocket>& TargetSockets = SocketCache.Resolve(InAttachParentComp->SkeletalMesh, InProjectileInfo.TargetBoneNames);
+
+				FVector InTargetSocketLoc = TargetSockets.IsValidIndex(InRandIndex)
+					? SocketCache.GetSocketTransform(InAttachParentComp, TargetSockets[InRandIndex]).GetLocation()
+					: InAttachParentComp->GetSocketLocation(InProjectileInfo.TargetBoneNames[InRandIndex]);
+				ProjectileMoveDir = InTargetSocketLoc - InStartLocation;
 			}
 		}
 	}
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "ProjectileSubsystem.h"
+#include "CombatSignificanceSubsystem.h"
 #include "CustomProjectileActor.generated.h"
 
 class USphereComponent;
@@ -10,6 +12,38 @@ class UCustomParticleSystemComponent;
 class UPointLightComponent;
 class UAudioComponent;
 class UProjectileMovementComponent;
+class UProjectileArchetype;
+
+/** 발사체마다 달라지는 값. 나머지는 UProjectileArchetype 에서 공유한다. */
+struct FProjectileShotInfo
+{
+	TWeakObjectPtr<AActor> Caster;
+	TWeakObjectPtr<AActor> Target;
+
+	float FireDelay = 0.f;
+
+	bool bPierceableChar = false;
+
+	/** 등록된 ICombatHitPolicy 의 대역이 쏜 발사체. 스킬 검사, 공격 가능 여부, 데미지 전송을 정책에 맡긴다. */
+	bool bSimulated = false;
+};
+
+/** 고정 스텝 적분 상태. 위치는 발사 시점 기준 해석해(탄도 공식)로 구한다. */
+struct FProjectileFixedStepState
+{
+	bool bEnabled = false;
+
+	FVector LaunchLocation = FVector::ZeroVector;
+	FVector LaunchVelocity = FVector::ZeroVector;
+	FVector Gravity = FVector::ZeroVector;
+
+	int32 StepIndex = 0;
+	float Accumulator = 0.f;
+	float MovedDistance = 0.f;
+
+	inline FVector GetLocation(const float InTime) const { return LaunchLocation + LaunchVelocity * InTime + Gravity * (0.5f * InTime * InTime); }
+	inline FVector GetVelocity(const float InTime) const { return LaunchVelocity + Gravity * InTime; }
+};
 
 UCLASS()
 class ACustomProjectileActor : public AActor
@@ -22,62 +56,106 @@ protected:
 
 public:
 	virtual void Tick(float DeltaSeconds) override;
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 		
-	void Fire(FSkillProjectileInfo InProjectileInfo);
+	void Fire(const FSkillProjectileInfo& InProjectileInfo);
 
 private:
+	friend class UProjectileSubsystem;
+	friend class UHazardSimulationSubsystem;
+
+	bool Launch(UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const bool bInPierceable, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor);
+	static bool CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo);
+
+	void Ignite();
+
+	/** UProjectileSubsystem 의 발사 예약 */
+	void OnScheduledFire();
+	void OnScheduledCancel();
+
+	/** 일제 사격에서 대상당 한 번만 맞도록 공유하는 경우 공유된 목록을 쓴다. */
+	inline FProjectileHitSet& GetHittedActor() { return SharedHittedActor.IsValid() ? *SharedHittedActor : HittedActor; }
+
 	void CheckSweep();
+	void SweepSegment(const FVector& InStart, const FVector& InEnd, const FVector& InVelocity);
+	void TickFixedStep(const float InDeltaTime);
 	void OnHit(const FHitResult& InHitResult);
+
+	/** 발사체 액터 없이도(히트스캔) 쓰는 판정 처리. 관통 불가로 멈춘 히트의 인덱스를 반환 */
+	static int ProcessSweepHits(ACustomCharacter* InCaster, const bool bInSimulated, const TArray<FHitResult>& InHits, const bool bInPierceableChar, const bool bInPierceableObject, TFunctionRef<void(const FHitResult&)> InOnHit);
+
+	/** 공격 가능 여부를 확인하고 정책에 알린다. 대역이면 정책이 답한다. */
+	static bool CheckAttackable(ICombatHitPolicy* InHitPolicy, const bool bInSimulated, ACustomCharacter* InCaster, AActor* InTarget);
+
+	/** 대역의 히트는 데미지를 보내지 않고 성공으로 처리한다. */
+	static bool SendHit(ACustomCharacter* InCaster, const bool bInSimulated, const FSkillProjectileInfo& InProjectileInfo, const FVector& InOrigin, const FHitResult& InHitResult);
+	static void SpawnHitAttachParticle(UWorld* InWorld, UParticleSystem* InHitParticle, ACustomCharacter* InHitCharacter, const TArray<FName>& InTargetBoneNames, const FVector& InImpactPoint, const FVector& InVelocity);
 	void OnDestroy();
 
+	UShapeComponent* CreateCollision();
+
+#if !UE_SERVER
 	void DeActiveParticleComponent();
 
+	void RegisterLight();
+	void UnregisterLight();
+
 	void ActiveAudioComponents();
 	void DeActiveAudioComponents();
 
-	UCustomSkeletalMeshComponent* CreateMesh(const FSkillProjectileInfo& InProjectileInfo);
-	UCustomParticleSystemComponent* CreateParticle(const FSkillProjectileInfo& InProjectileInfo);
-	UShapeComponent* CreateCollision(const FSkillProjectileInfo& InProjectileInfo);
-	UPointLightComponent* CreateLight(const FSkillProjectileInfo& InProjectileInfo);
-	TArray<TWeakObjectPtr<UAudioComponent>> CreateSound(const FSkillProjectileInfo& InProjectileInfo);
+	UCustomSkeletalMeshComponent* CreateMesh();
+	UCustomParticleSystemComponent* CreateParticle();
+	UPointLightComponent* CreateLight();
+	TArray<TWeakObjectPtr<UAudioComponent>> CreateSound();
+
+	/** Significance - 멀거나 화면 밖인 발사체의 틱, 파티클 LOD, 라이트, 사운드를 낮춘다. */
+	void RegisterSignificance();
+	void ApplySignificance(const ECombatSignificance InSignificance);
+#endif
 
-	FVector CalcMoveDir(const FSkillProjectileInfo& InProjectileInfo);
+	static FVector CalcMoveDir(UWorld* InWorld, const FSkillProjectileInfo& InProjectileInfo, const FVector& InStartLocation);
 
 
 private:
 	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
 	UShapeComponent* CollisionComponent = nullptr;
 
-	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
-	UCustomSkeletalMeshComponent* SkeletalMeshComponent = nullptr;
-
-	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
-	UCustomParticleSystemComponent* ParticleSystemComponent = nullptr;
-
-	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
-	UPointLightComponent* PointLightComponent = nullptr;
-
-	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
-	TArray<TWeakObjectPtr<UAudioComponent>> AudioComponents;
-
-	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
-	TArray<FSoundInfo> SoundInfos;
-
 	UPROPERTY(VisibleAnywhere, Category = Projectile)
 	UProjectileMovementComponent* ProjectileMovementComponent = nullptr;
 
+	/** 서버 프레임레이트와 무관한 고정 스텝 이동/판정 사용 (Projectile.FixedStep.* 참고) */
+	UPROPERTY(EditDefaultsOnly, Category = Projectile)
+	bool bUseFixedStepIntegration = false;
+
 
 private:
 	TArray<FTransform> PreElemTM;
 	FTransform StartElemTM;
 	FTransform EndElemTM;
 
-	TSet<TWeakObjectPtr<const AActor>> HittedActor;
-	FSkillProjectileInfo m_ProjectileInfo;
+	FProjectileHitSet HittedActor;
+	TSharedPtr<FProjectileHitSet> SharedHittedActor;
+
+	UPROPERTY()
+	UProjectileArchetype* Archetype = nullptr;
+
+	FProjectileShotInfo ShotInfo;
+	FProjectileFixedStepState FixedStep;
 
 	bool bActive = true;
 
 	float ElapsedTime = 0.f;
 
 	FDelegateHandle OnHitReactionHandle;
+
+#if !UE_SERVER
+	/** Visual - 서버 빌드에서는 없음. (UPROPERTY 대신 AddReferencedObjects 로 참조) */
+	UCustomSkeletalMeshComponent* SkeletalMeshComponent = nullptr;
+	UCustomParticleSystemComponent* ParticleSystemComponent = nullptr;
+	UPointLightComponent* PointLightComponent = nullptr;
+	TArray<TWeakObjectPtr<UAudioComponent>> AudioComponents;
+
+	ECombatSignificance Significance = ECombatSignificance::Critical;
+#endif
 };
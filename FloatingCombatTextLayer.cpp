@@ -0,0 +1,252 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FloatingCombatTextLayer.h"
+#include "Components/CanvasPanel.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Components/TextBlock.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "SceneView.h"
+
+DECLARE_CYCLE_STAT(TEXT("Floating Combat Text Tick"), STAT_FloatingCombatTextTick, STATGROUP_WidgetPool);
+
+static TAutoConsoleVariable<int32> CVarCombatTextMaxEntries(
+	TEXT("CombatText.MaxEntries"),
+	0,
+	TEXT("Overrides the max number of floating combat text entries. 0: use the layer setting."),
+	ECVF_Default);
+
+static TArray<TWeakObjectPtr<UFloatingCombatTextLayer>> GFloatingCombatTextLayers;
+
+void UFloatingCombatTextEntry::SetEntry(const FText& InText, const FLinearColor& InColor)
+{
+	if (ValueText != nullptr)
+	{
+		ValueText->SetText(InText);
+		ValueText->SetColorAndOpacity(FSlateColor(InColor));
+	}
+}
+
+UFloatingCombatTextLayer* UFloatingCombatTextLayer::Get(const UObject* InWorldContext)
+{
+	const UWorld* InWorld = InWorldContext ? InWorldContext->GetWorld() : nullptr;
+	for (const TWeakObjectPtr<UFloatingCombatTextLayer>& InLayer : GFloatingCombatTextLayers)
+	{
+		if (InLayer.IsValid() && InLayer->GetWorld() == InWorld)
+		{
+			return InLayer.Get();
+		}
+	}
+
+	return nullptr;
+}
+
+void UFloatingCombatTextLayer::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	if (IsValid(EntryCanvas))
+	{
+		Pool.Init(EntryCanvas, EntryClass);
+	}
+
+	GFloatingCombatTextLayers.RemoveAllSwap([](const TWeakObjectPtr<UFloatingCombatTextLayer>& InLayer) { return InLayer.IsValid() == false; });
+	GFloatingCombatTextLayers.AddUnique(this);
+}
+
+void UFloatingCombatTextLayer::NativeDestruct()
+{
+	GFloatingCombatTextLayers.Remove(this);
+
+	Entries.Empty();
+	ParkedWidgets.Empty();
+	Pool.Clear();
+
+	Super::NativeDestruct();
+}
+
+int32 UFloatingCombatTextLayer::Add(const FFloatingCombatTextDesc& InDesc)
+{
+	if (IsValid(EntryCanvas) == false || EntryClass == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	// 가득 찬 경우 우선순위가 낮은 것을 밀어낸다. (새 항목이 가장 낮으면 버림)
+	if (Entries.Num() >= GetMaxEntries())
+	{
+		const int32 EvictIndex = FindEvictIndex();
+		if (EvictIndex == INDEX_NONE || Entries[EvictIndex].Desc.Priority > InDesc.Priority)
+		{
+			return INDEX_NONE;
+		}
+
+		ReleaseAt(EvictIndex);
+	}
+
+	UFloatingCombatTextEntry* InWidget = ParkedWidgets.Num() > 0 ? ParkedWidgets.Pop(false) : nullptr;
+	if (InWidget == nullptr)
+	{
+		InWidget = Pool.AddToPanel();
+		if (InWidget == nullptr)
+		{
+			return INDEX_NONE;
+		}
+
+		// 위치는 RenderTranslation 으로만 정한다.
+		if (UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(InWidget->Slot))
+		{
+			CanvasSlot->SetAutoSize(true);
+			CanvasSlot->SetAlignment(FVector2D(0.5f, 0.5f));
+			CanvasSlot->SetPosition(FVector2D::ZeroVector);
+		}
+	}
+
+	// 첫 틱에서 위치를 정한 뒤에 보인다.
+	InWidget->SetVisibility(ESlateVisibility::Collapsed);
+	InWidget->SetEntry(InDesc.Text, InDesc.Color);
+
+	FFloatingCombatTextState& NewState = Entries.AddDefaulted_GetRef();
+	NewState.Widget = InWidget;
+	NewState.Desc = InDesc;
+	NewState.EntryId = NextEntryId++;
+
+	if (NextEntryId == MAX_int32)
+	{
+		NextEntryId = 0;
+	}
+
+	return NewState.EntryId;
+}
+
+void UFloatingCombatTextLayer::Remove(const int32 InEntryId)
+{
+	const int32 Index = Entries.IndexOfByPredicate([InEntryId](const FFloatingCombatTextState& InState) { return InState.EntryId == InEntryId; });
+	if (Index != INDEX_NONE)
+	{
+		ReleaseAt(Index);
+	}
+}
+
+void UFloatingCombatTextLayer::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FloatingCombatTextTick);
+
+	// 뷰 행렬은 프레임에 한 번
+	APlayerController* InController = GetOwningPlayer();
+	ULocalPlayer* InLocalPlayer = InController ? InController->GetLocalPlayer() : nullptr;
+
+	FSceneViewProjectionData ProjectionData;
+	const bool bHasView = InLocalPlayer != nullptr && InLocalPlayer->ViewportClient != nullptr &&
+		InLocalPlayer->GetProjectionData(InLocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData);
+
+	const FMatrix ViewProjectionMatrix = bHasView ? ProjectionData.ComputeViewProjectionMatrix() : FMatrix::Identity;
+	const FIntRect ViewRect = bHasView ? ProjectionData.GetConstrainedViewRect() : FIntRect();
+	const float InvViewportScale = 1.f / FMath::Max(UWidgetLayoutLibrary::GetViewportScale(this), KINDA_SMALL_NUMBER);
+	const float MaxDistanceSq = FMath::Square(MaxDistance);
+
+	for (int32 Index = Entries.Num() - 1; Index >= 0; Index--)
+	{
+		FFloatingCombatTextState& InState = Entries[Index];
+		InState.Age += InDeltaTime;
+
+		const float LifeTime = InState.Desc.LifeTime;
+		if (LifeTime > 0.f && InState.Age >= LifeTime)
+		{
+			ReleaseAt(Index);
+			continue;
+		}
+
+		// 대상이 사라지면 마지막 위치에 남긴다.
+		if (const AActor* FollowActor = InState.Desc.FollowActor.Get())
+		{
+			InState.Desc.WorldLocation = FollowActor->GetActorLocation() + InState.Desc.Offset;
+		}
+		else if (LifeTime <= 0.f && InState.Desc.FollowActor.IsExplicitlyNull() == false)
+		{
+			// 이름표는 대상과 함께 사라진다.
+			ReleaseAt(Index);
+			continue;
+		}
+
+		const FVector WorldLocation = InState.Desc.WorldLocation + FVector(0.f, 0.f, InState.Desc.RiseSpeed * InState.Age);
+
+		// Culling
+		FVector2D ScreenPosition;
+		const bool bVisible = bHasView == true &&
+			FVector::DistSquared(ProjectionData.ViewOrigin, WorldLocation) <= MaxDistanceSq &&
+			FSceneView::ProjectWorldToScreen(WorldLocation, ViewRect, ViewProjectionMatrix, ScreenPosition) == true &&
+			ViewRect.Contains(ScreenPosition.IntPoint()) == true;
+
+		if (bVisible != InState.bShown)
+		{
+			InState.bShown = bVisible;
+			InState.Widget->SetVisibility(bVisible ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+		}
+
+		if (bVisible == false)
+		{
+			continue;
+		}
+
+		// Animation
+		float Opacity = 1.f;
+		if (LifeTime > 0.f && FadeOutRatio > 0.f)
+		{
+			const float Ratio = InState.Age / LifeTime;
+			Opacity = FMath::Clamp((1.f - Ratio) / FadeOutRatio, 0.f, 1.f);
+		}
+
+		const float Scale = PopTime > 0.f ? FMath::Lerp(PopScale, 1.f, FMath::Clamp(InState.Age / PopTime, 0.f, 1.f)) : 1.f;
+
+		InState.Widget->SetRenderTranslation((ScreenPosition - FVector2D(ViewRect.Min)) * InvViewportScale);
+		InState.Widget->SetRenderOpacity(Opacity);
+		InState.Widget->SetRenderScale(FVector2D(Scale, Scale));
+	}
+}
+
+int32 UFloatingCombatTextLayer::GetMaxEntries() const
+{
+	const int32 MaxEntriesOverride = CVarCombatTextMaxEntries.GetValueOnGameThread();
+	return FMath::Max(MaxEntriesOverride > 0 ? MaxEntriesOverride : MaxEntries, 1);
+}
+
+int32 UFloatingCombatTextLayer::FindEvictIndex() const
+{
+	int32 OutIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Entries.Num(); Index++)
+	{
+		if (OutIndex == INDEX_NONE)
+		{
+			OutIndex = Index;
+			continue;
+		}
+
+		const FFloatingCombatTextState& InState = Entries[Index];
+		const FFloatingCombatTextState& OutState = Entries[OutIndex];
+		if (InState.Desc.Priority < OutState.Desc.Priority ||
+			(InState.Desc.Priority == OutState.Desc.Priority && InState.Age > OutState.Age))
+		{
+			OutIndex = Index;
+		}
+	}
+
+	return OutIndex;
+}
+
+void UFloatingCombatTextLayer::ReleaseAt(const int32 InIndex)
+{
+	UFloatingCombatTextEntry* InWidget = Entries[InIndex].Widget;
+	InWidget->SetVisibility(ESlateVisibility::Collapsed);
+	ParkedWidgets.Emplace(InWidget);
+
+	Entries.RemoveAtSwap(InIndex, 1, false);
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "WidgetPool.h"
+#include "FloatingCombatTextLayer.generated.h"
+
+class UCanvasPanel;
+class UTextBlock;
+
+struct FFloatingCombatTextDesc
+{
+	/** FollowActor 가 있으면 액터 위치 + Offset, 없으면 WorldLocation 고정 */
+	TWeakObjectPtr<AActor> FollowActor;
+	FVector WorldLocation = FVector::ZeroVector;
+	FVector Offset = FVector::ZeroVector;
+
+	FText Text;
+	FLinearColor Color = FLinearColor::White;
+
+	/** 0 이면 Remove 할 때까지 유지 (이름표 등) */
+	float LifeTime = 1.f;
+	float RiseSpeed = 60.f;
+
+	/** 가득 찼을 때 낮은 것부터 밀려난다. (로컬 플레이어 관련, 치명타 등을 높게) */
+	int32 Priority = 0;
+};
+
+/** 레이어 항목 하나. 텍스트, 색만 받고 위치, 투명도, 크기는 레이어가 정한다. */
+UCLASS(Abstract)
+class UFloatingCombatTextEntry : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	virtual void SetEntry(const FText& InText, const FLinearColor& InColor);
+
+protected:
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* ValueText = nullptr;
+};
+
+/**
+ * 대미지 숫자, 이름표를 한 캔버스에서 그린다.
+ * 항목마다 따로 위치를 계산하지 않고, 한 프레임에 한 번 뷰 행렬을 구해서 모든 항목의 투영, 애니메이션, 컬링을 한 번에 처리한다.
+ * 위치는 RenderTransform 으로만 바꾸므로 레이아웃이 다시 계산되지 않는다.
+ *
+ * 위젯 생성은 TWidgetPool 이 맡고 (GC 참조는 PoolLists 로), 끝난 항목은 패널에서 떼지 않고 Collapsed 로 두었다가 다시 쓴다.
+ * 최대 개수(MaxEntries, CombatText.MaxEntries)를 넘으면 우선순위가 낮고 오래된 항목부터 밀어낸다.
+ */
+UCLASS(Abstract)
+class UFloatingCombatTextLayer : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	static UFloatingCombatTextLayer* Get(const UObject* InWorldContext);
+
+	/** 반환값은 Remove 용 (INDEX_NONE 이면 추가되지 않음) */
+	int32 Add(const FFloatingCombatTextDesc& InDesc);
+	void Remove(const int32 InEntryId);
+
+	inline int32 GetNumEntries() const { return Entries.Num(); }
+
+protected:
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+private:
+	struct FFloatingCombatTextState
+	{
+		UFloatingCombatTextEntry* Widget = nullptr;
+		FFloatingCombatTextDesc Desc;
+		int32 EntryId = INDEX_NONE;
+		float Age = 0.f;
+		bool bShown = false;
+	};
+
+	int32 GetMaxEntries() const;
+	int32 FindEvictIndex() const;
+	void ReleaseAt(const int32 InIndex);
+
+private:
+	UPROPERTY(meta = (BindWidget))
+	UCanvasPanel* EntryCanvas = nullptr;
+
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	TSubclassOf<UFloatingCombatTextEntry> EntryClass;
+
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	int32 MaxEntries = 200;
+
+	/** 이 거리보다 멀면 숨긴다. */
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	float MaxDistance = 5000.f;
+
+	/** 수명 끝부분에서 사라지는 비율 */
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	float FadeOutRatio = 0.3f;
+
+	/** 처음 나타날 때 크기 (PopTime 동안 1 로 줄어듦) */
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	float PopScale = 1.5f;
+
+	UPROPERTY(EditDefaultsOnly, Category = CombatText)
+	float PopTime = 0.1f;
+
+	UPROPERTY(Transient)
+	FWidgetPoolLists PoolLists;
+
+	TWidgetPool<UFloatingCombatTextEntry> Pool{ PoolLists };
+
+	/** 보이는 항목 (순서 없음) */
+	TArray<FFloatingCombatTextState> Entries;
+
+	/** 끝난 항목 위젯 (패널에 붙은 채 Collapsed, Pool 의 활성 목록으로 참조) */
+	TArray<UFloatingCombatTextEntry*> ParkedWidgets;
+
+	int32 NextEntryId = 0;
+};
@@ -0,0 +1,935 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HazardSimulationSubsystem.h"
+#include "Component/AreaComponent.h"
+#include "CustomProjectileActor.h"
+#include "ProjectileArchetype.h"
+#include "Components/CapsuleComponent.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+static TAutoConsoleVariable<int32> CVarHazardParallel(
+	TEXT("Hazard.Parallel"),
+	1,
+	TEXT("1: process hazard chunks with ParallelFor. 0: process on the game thread (debug)."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarHazardCellSize(
+	TEXT("Hazard.CellSize"),
+	1000.f,
+	TEXT("Grid cell size of the character snapshot used by the hazard simulation."),
+	ECVF_Default);
+
+namespace HazardSimulation
+{
+	/** FHazardTargetSnapshot::ChannelMasks - 영역은 ECC_GameTraceChannel1, 발사체는 ECC_GameTraceChannel12 */
+	static constexpr uint8 TargetMask_Area = 1 << 0;
+	static constexpr uint8 TargetMask_Projectile = 1 << 1;
+
+	/** 캡슐 축 선분 */
+	static inline void GetCapsuleSegment(const FVector& InCenter, const float InRadius, const float InHalfHeight, FVector& OutBottom, FVector& OutTop)
+	{
+		const float SegmentHalfHeight = FMath::Max(InHalfHeight - InRadius, 0.f);
+		OutBottom = InCenter - FVector(0.f, 0.f, SegmentHalfHeight);
+		OutTop = InCenter + FVector(0.f, 0.f, SegmentHalfHeight);
+	}
+
+	static float GetPatternRadius(const FHazardAreaPattern& InPattern)
+	{
+		switch (InPattern.ShapeType)
+		{
+		case ECollisionSweepShapeType::Box:		return InPattern.Extent.Size();
+		case ECollisionSweepShapeType::Capsule:	return FMath::Max(InPattern.Extent.X, InPattern.Extent.Y) + InPattern.Extent.Z;
+		default:								return InPattern.Extent.X;
+		}
+	}
+
+	/** CheckOverlap 의 물리 판정 + 모양별 처리와 같은 결과 */
+	static bool IsInsidePattern(const FHazardAreaPattern& InPattern, const FVector& InLocation, const float InRadius, const float InHalfHeight)
+	{
+		FVector CapsuleBottom, CapsuleTop;
+		GetCapsuleSegment(InLocation, InRadius, InHalfHeight, CapsuleBottom, CapsuleTop);
+
+		switch (InPattern.ShapeType)
+		{
+		case ECollisionSweepShapeType::Box:
+		{
+			// 박스 공간에서 캡슐 선분과 박스의 가장 가까운 점을 번갈아 투영해 찾는다. (볼록 집합이므로 몇 번이면 충분)
+			const FVector LocalBottom = InPattern.Rotation.UnrotateVector(CapsuleBottom - InPattern.Center);
+			const FVector LocalTop = InPattern.Rotation.UnrotateVector(CapsuleTop - InPattern.Center);
+
+			FVector PointOnSegment = (LocalBottom + LocalTop) * 0.5f;
+			FVector PointOnBox = PointOnSegment;
+			for (int Iteration = 0; Iteration < 3; Iteration++)
+			{
+				PointOnBox = PointOnSegment.BoundToBox(-InPattern.Extent, InPattern.Extent);
+				PointOnSegment = FMath::ClosestPointOnSegment(PointOnBox, LocalBottom, LocalTop);
+			}
+
+			return FVector::DistSquared(PointOnSegment, PointOnSegment.BoundToBox(-InPattern.Extent, InPattern.Extent)) <= FMath::Square(InRadius);
+		}
+		case ECollisionSweepShapeType::Capsule:
+		{
+			const float PatternRadius = FMath::Max(InPattern.Extent.X, InPattern.Extent.Y);
+			const float PatternSegmentHalfHeight = FMath::Max(InPattern.Extent.Z - PatternRadius, 0.f);
+			const FVector PatternAxis = InPattern.Rotation.GetAxisZ() * PatternSegmentHalfHeight;
+
+			FVector PointOnPattern, PointOnCapsule;
+			FMath::SegmentDistToSegmentSafe(InPattern.Center - PatternAxis, InPattern.Center + PatternAxis, CapsuleBottom, CapsuleTop, PointOnPattern, PointOnCapsule);
+			return FVector::DistSquared(PointOnPattern, PointOnCapsule) <= FMath::Square(PatternRadius + InRadius);
+		}
+		default:
+			break;
+		}
+
+		// Sphere, Sector, Ring
+		const FVector PointOnCapsule = FMath::ClosestPointOnSegment(InPattern.Center, CapsuleBottom, CapsuleTop);
+		if (FVector::DistSquared(PointOnCapsule, InPattern.Center) > FMath::Square(InPattern.Extent.X + InRadius))
+		{
+			return false;
+		}
+
+		const FVector AreaLookTargetVector = InLocation - InPattern.Center;
+
+		if (InPattern.ShapeType == ECollisionSweepShapeType::Sector)
+		{
+			const FVector RightVector = AreaLookTargetVector.ToOrientationQuat().GetRightVector();
+			const FVector CrossProduct = FVector::CrossProduct(InPattern.Dir, AreaLookTargetVector);
+			const FVector RadiusVector = CrossProduct.Z < 0.f ? RightVector * InRadius : RightVector * InRadius * -1.f;
+			const FVector FinalAreaLookTargetDir = AreaLookTargetVector + RadiusVector;
+
+			const float InDiffAngleNoCapsule = MyUtility::GetTargetAngle(InPattern.Dir, AreaLookTargetVector.GetSafeNormal2D());
+			const float InDiffAngleWithCapsule = MyUtility::GetTargetAngle(InPattern.Dir, FinalAreaLookTargetDir.GetSafeNormal2D());
+			const float InCheckAngle = InPattern.SectorAngle / 2;
+			return InDiffAngleNoCapsule <= InCheckAngle || InDiffAngleWithCapsule <= InCheckAngle;
+		}
+
+		if (InPattern.ShapeType == ECollisionSweepShapeType::Ring)
+		{
+			const float ExcludeRingRadius = InPattern.Extent.X - InPattern.RingWidth;
+			return AreaLookTargetVector.Size2D() + InRadius >= ExcludeRingRadius;
+		}
+
+		return true;
+	}
+}
+
+void FHazardChunkBase::Init()
+{
+	HandleIndices.SetNumUninitialized(Capacity);
+	Casters.SetNum(Capacity);
+	CasterKeys.SetNum(Capacity);
+	Expired.SetNumZeroed(Capacity);
+	Hits.Reserve(Capacity);
+}
+
+void FHazardChunkBase::MoveEntity(const int32 InFrom, const int32 InTo)
+{
+	HandleIndices[InTo] = HandleIndices[InFrom];
+	Casters[InTo] = MoveTemp(Casters[InFrom]);
+	CasterKeys[InTo] = CasterKeys[InFrom];
+	Expired[InTo] = Expired[InFrom];
+}
+
+void FHazardAreaChunk::Init()
+{
+	FHazardChunkBase::Init();
+
+	BoundsCenters.SetNumZeroed(Capacity);
+	BoundsRadii.SetNumZeroed(Capacity);
+	Patterns.SetNum(Capacity);
+	ElapsedTimes.SetNumZeroed(Capacity);
+	LifeTimes.SetNumZeroed(Capacity);
+	SectionTimes.SetNumZeroed(Capacity);
+	DotTimers.SetNum(Capacity);
+	AreaInfos.SetNum(Capacity);
+}
+
+void FHazardAreaChunk::MoveEntity(const int32 InFrom, const int32 InTo)
+{
+	FHazardChunkBase::MoveEntity(InFrom, InTo);
+
+	BoundsCenters[InTo] = BoundsCenters[InFrom];
+	BoundsRadii[InTo] = BoundsRadii[InFrom];
+	Patterns[InTo] = MoveTemp(Patterns[InFrom]);
+	ElapsedTimes[InTo] = ElapsedTimes[InFrom];
+	LifeTimes[InTo] = LifeTimes[InFrom];
+	SectionTimes[InTo] = SectionTimes[InFrom];
+	DotTimers[InTo] = MoveTemp(DotTimers[InFrom]);
+	AreaInfos[InTo] = MoveTemp(AreaInfos[InFrom]);
+}
+
+void FHazardProjectileChunk::Init()
+{
+	FHazardChunkBase::Init();
+
+	Locations.SetNumZeroed(Capacity);
+	Velocities.SetNumZeroed(Capacity);
+	GravityZ.SetNumZeroed(Capacity);
+	SweepRadii.SetNumZeroed(Capacity);
+	FireDelays.SetNumZeroed(Capacity);
+	RemainDistances.SetNumZeroed(Capacity);
+	RemainLifeTimes.SetNumZeroed(Capacity);
+	HittedTargets.SetNum(Capacity);
+	bPierceable.SetNumZeroed(Capacity);
+	Archetypes.SetNumZeroed(Capacity);
+	Origins.SetNumZeroed(Capacity);
+}
+
+void FHazardProjectileChunk::MoveEntity(const int32 InFrom, const int32 InTo)
+{
+	FHazardChunkBase::MoveEntity(InFrom, InTo);
+
+	Locations[InTo] = Locations[InFrom];
+	Velocities[InTo] = Velocities[InFrom];
+	GravityZ[InTo] = GravityZ[InFrom];
+	SweepRadii[InTo] = SweepRadii[InFrom];
+	FireDelays[InTo] = FireDelays[InFrom];
+	RemainDistances[InTo] = RemainDistances[InFrom];
+	RemainLifeTimes[InTo] = RemainLifeTimes[InFrom];
+	HittedTargets[InTo] = MoveTemp(HittedTargets[InFrom]);
+	bPierceable[InTo] = bPierceable[InFrom];
+	Archetypes[InTo] = Archetypes[InFrom];
+	Origins[InTo] = Origins[InFrom];
+}
+
+void UHazardSimulationSubsystem::FHazardTargetSnapshot::Reset()
+{
+	Actors.Reset();
+	Keys.Reset();
+	Locations.Reset();
+	Radii.Reset();
+	HalfHeights.Reset();
+	ChannelMasks.Reset();
+	MaxRadius = 0.f;
+
+	for (TPair<FIntPoint, TArray<int32, TInlineAllocator<8>>>& Cell : Cells)
+	{
+		Cell.Value.Reset();
+	}
+}
+
+void UHazardSimulationSubsystem::Deinitialize()
+{
+	AreaChunks.Empty();
+	ProjectileChunks.Empty();
+	EntitySlots.Empty();
+	FreeEntitySlots.Empty();
+	NumAreas = 0;
+	NumProjectiles = 0;
+
+	Targets.Reset();
+	Targets.Cells.Empty();
+	AreaBridges.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHazardSimulationSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UHazardSimulationSubsystem* This = CastChecked<UHazardSimulationSubsystem>(InThis);
+	for (FHazardProjectileChunk& Chunk : This->ProjectileChunks)
+	{
+		for (int Index = 0; Index < Chunk.Num; Index++)
+		{
+			Collector.AddReferencedObject(Chunk.Archetypes[Index], This);
+		}
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UHazardSimulationSubsystem::Tick(float DeltaTime)
+{
+	BuildTargetSnapshot();
+
+	// 시전자 상태는 게임 스레드에서 미리 확인 (처리기는 UObject 를 읽지 않는다.)
+	for (FHazardAreaChunk& Chunk : AreaChunks)
+	{
+		for (int Index = 0; Index < Chunk.Num; Index++)
+		{
+			ACustomCharacter* Caster = Chunk.Casters[Index].Get();
+			if (IsValid(Caster) == false || Caster->IsDie())
+			{
+				Chunk.Expired[Index] = true;
+			}
+		}
+	}
+
+	for (FHazardProjectileChunk& Chunk : ProjectileChunks)
+	{
+		for (int Index = 0; Index < Chunk.Num; Index++)
+		{
+			if (Chunk.Casters[Index].IsValid() == false || IsValid(Chunk.Archetypes[Index]) == false)
+			{
+				Chunk.Expired[Index] = true;
+			}
+		}
+	}
+
+	// Evaluate - 청크마다 독립이므로 병렬로 처리
+	const int32 NumAreaChunks = AreaChunks.Num();
+	ParallelFor(NumAreaChunks + ProjectileChunks.Num(), [this, NumAreaChunks, DeltaTime](int32 ChunkIndex)
+	{
+		if (ChunkIndex < NumAreaChunks)
+		{
+			ProcessAreaChunk(AreaChunks[ChunkIndex], DeltaTime);
+		}
+		else
+		{
+			ProcessProjectileChunk(ProjectileChunks[ChunkIndex - NumAreaChunks], DeltaTime);
+		}
+	}, CVarHazardParallel.GetValueOnGameThread() == 0);
+
+	// Apply - 청크 순서대로
+	for (FHazardAreaChunk& Chunk : AreaChunks)
+	{
+		ApplyAreaHits(Chunk, DeltaTime);
+	}
+
+	for (FHazardProjectileChunk& Chunk : ProjectileChunks)
+	{
+		ApplyProjectileHits(Chunk);
+	}
+
+	RemoveExpired();
+}
+
+FHazardHandle UHazardSimulationSubsystem::SpawnArea(const FSkillAreaInfo& InAreaInfo)
+{
+	if (GetWorld()->GetNetMode() == NM_Client || IsValid(InAreaInfo.Caster) == false || InAreaInfo.AreaClass == nullptr)
+	{
+		return FHazardHandle();
+	}
+
+	FSkillAreaInfo CalculatedAreaInfo;
+	UAreaComponent::CalculateAreaInfo(InAreaInfo, CalculatedAreaInfo);
+
+	TArray<FAreaOverlapInfo> OverlapInfos;
+	UAreaComponent::BuildOverlapInfos(CalculatedAreaInfo, OverlapInfos);
+	if (OverlapInfos.Num() == 0)
+	{
+		return FHazardHandle();
+	}
+
+	const int32 ChunkIndex = FindOrAddChunk(AreaChunks);
+	FHazardAreaChunk& Chunk = AreaChunks[ChunkIndex];
+	const int32 EntityIndex = Chunk.Num++;
+
+	TArray<FHazardAreaPattern, TInlineAllocator<2>>& Patterns = Chunk.Patterns[EntityIndex];
+	Patterns.Reset();
+
+	float StartTime = CalculatedAreaInfo.CollisionCheckDelay;
+	for (const FAreaOverlapInfo& OverlapInfo : OverlapInfos)
+	{
+		StartTime += OverlapInfo.PatternDelay;
+
+		FHazardAreaPattern& NewPattern = Patterns.AddDefaulted_GetRef();
+		NewPattern.ShapeType = OverlapInfo.ShapeType;
+		NewPattern.Center = OverlapInfo.OverlapCollisionTM.GetLocation();
+		NewPattern.Rotation = OverlapInfo.Dir.ToOrientationQuat();
+		NewPattern.Dir = OverlapInfo.Dir;
+		NewPattern.Extent = OverlapInfo.Extent;
+		NewPattern.RingWidth = OverlapInfo.RingWidth;
+		NewPattern.SectorAngle = OverlapInfo.SectorAngle;
+		NewPattern.StartTime = StartTime;
+	}
+
+	float BoundsRadius = 0.f;
+	for (const FHazardAreaPattern& Pattern : Patterns)
+	{
+		BoundsRadius = FMath::Max(BoundsRadius, FVector::Dist(Patterns[0].Center, Pattern.Center) + HazardSimulation::GetPatternRadius(Pattern));
+	}
+
+	Chunk.Casters[EntityIndex] = InAreaInfo.Caster;
+	Chunk.CasterKeys[EntityIndex] = FObjectKey(InAreaInfo.Caster);
+	Chunk.Expired[EntityIndex] = false;
+	Chunk.BoundsCenters[EntityIndex] = Patterns[0].Center;
+	Chunk.BoundsRadii[EntityIndex] = BoundsRadius;
+	Chunk.ElapsedTimes[EntityIndex] = 0.f;
+	Chunk.LifeTimes[EntityIndex] = CalculatedAreaInfo.AreaLifeTime;
+	Chunk.SectionTimes[EntityIndex] = FMath::Max(CalculatedAreaInfo.AreaSectionTime, 0.f);
+	Chunk.DotTimers[EntityIndex].Reset();
+	Chunk.AreaInfos[EntityIndex] = MoveTemp(CalculatedAreaInfo);
+
+	NumAreas++;
+	return AllocateHandle(EHazardKind::Area, ChunkIndex, EntityIndex);
+}
+
+FHazardHandle UHazardSimulationSubsystem::SpawnProjectile(const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo)
+{
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(InProjectileInfo.Caster);
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (GetWorld()->GetNetMode() == NM_Client || IsValid(InCaster) == false || ProjectileSubsystem == nullptr)
+	{
+		return FHazardHandle();
+	}
+
+	UProjectileArchetype* InArchetype = ProjectileSubsystem->FindOrCompileArchetype(InProjectileInfo);
+	if (IsValid(InArchetype) == false)
+	{
+		return FHazardHandle();
+	}
+
+	// ApplyLagCompensation 과 같은 방식으로 모양을 구로 근사
+	const FCollisionShape& InShape = InArchetype->GetSweepShape();
+	float SweepRadius = 0.f;
+	switch (InShape.ShapeType)
+	{
+	case ECollisionShape::Sphere:	SweepRadius = InShape.GetSphereRadius(); break;
+	case ECollisionShape::Box:		SweepRadius = InShape.GetExtent().Size(); break;
+	case ECollisionShape::Capsule:	SweepRadius = InShape.GetCapsuleHalfHeight(); break;
+	default: break;
+	}
+
+	const int32 ChunkIndex = FindOrAddChunk(ProjectileChunks);
+	FHazardProjectileChunk& Chunk = ProjectileChunks[ChunkIndex];
+	const int32 EntityIndex = Chunk.Num++;
+
+	const FVector StartLocation = InSpawnTM.GetLocation();
+
+	Chunk.Casters[EntityIndex] = InCaster;
+	Chunk.CasterKeys[EntityIndex] = FObjectKey(InCaster);
+	Chunk.Expired[EntityIndex] = false;
+	Chunk.Locations[EntityIndex] = StartLocation;
+	Chunk.Velocities[EntityIndex] = ACustomProjectileActor::CalcMoveDir(GetWorld(), InProjectileInfo, StartLocation) * InProjectileInfo.ProjectileSpeed;
+	Chunk.GravityZ[EntityIndex] = GetWorld()->GetGravityZ() * InProjectileInfo.ProjectileGravityScale;
+	Chunk.SweepRadii[EntityIndex] = SweepRadius;
+	Chunk.FireDelays[EntityIndex] = FMath::Max(InProjectileInfo.FireDelay, 0.f);
+	Chunk.RemainDistances[EntityIndex] = InArchetype->GetMaxMoveDistance();
+	Chunk.RemainLifeTimes[EntityIndex] = InArchetype->GetLifeSpan(InProjectileInfo.FireDelay);
+	Chunk.HittedTargets[EntityIndex].Reset();
+	Chunk.bPierceable[EntityIndex] = ACustomProjectileActor::CalcPierceable(InCaster, InProjectileInfo);
+	Chunk.Archetypes[EntityIndex] = InArchetype;
+	Chunk.Origins[EntityIndex] = StartLocation;
+
+	NumProjectiles++;
+	return AllocateHandle(EHazardKind::Projectile, ChunkIndex, EntityIndex);
+}
+
+void UHazardSimulationSubsystem::Despawn(const FHazardHandle InHandle)
+{
+	if (IsAlive(InHandle) == false)
+	{
+		return;
+	}
+
+	// OnAreaIn 등에서 호출될 수 있으므로 표시만 하고 틱 끝에서 제거
+	const FHazardEntitySlot& Slot = EntitySlots[InHandle.Index];
+	if (Slot.Kind == EHazardKind::Area)
+	{
+		AreaChunks[Slot.ChunkIndex].Expired[Slot.EntityIndex] = true;
+	}
+	else
+	{
+		ProjectileChunks[Slot.ChunkIndex].Expired[Slot.EntityIndex] = true;
+	}
+}
+
+bool UHazardSimulationSubsystem::IsAlive(const FHazardHandle InHandle) const
+{
+	if (EntitySlots.IsValidIndex(InHandle.Index) == false)
+	{
+		return false;
+	}
+
+	const FHazardEntitySlot& Slot = EntitySlots[InHandle.Index];
+	if (Slot.Serial != InHandle.Serial || Slot.ChunkIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	return Slot.Kind == EHazardKind::Area
+		? AreaChunks[Slot.ChunkIndex].Expired[Slot.EntityIndex] == false
+		: ProjectileChunks[Slot.ChunkIndex].Expired[Slot.EntityIndex] == false;
+}
+
+FHazardHandle UHazardSimulationSubsystem::AllocateHandle(const EHazardKind InKind, const int32 InChunkIndex, const int32 InEntityIndex)
+{
+	const int32 SlotIndex = FreeEntitySlots.Num() > 0 ? FreeEntitySlots.Pop(false) : EntitySlots.AddDefaulted();
+
+	FHazardEntitySlot& Slot = EntitySlots[SlotIndex];
+	Slot.Kind = InKind;
+	Slot.ChunkIndex = InChunkIndex;
+	Slot.EntityIndex = InEntityIndex;
+	Slot.Serial++;
+
+	if (InKind == EHazardKind::Area)
+	{
+		AreaChunks[InChunkIndex].HandleIndices[InEntityIndex] = SlotIndex;
+	}
+	else
+	{
+		ProjectileChunks[InChunkIndex].HandleIndices[InEntityIndex] = SlotIndex;
+	}
+
+	FHazardHandle NewHandle;
+	NewHandle.Index = SlotIndex;
+	NewHandle.Serial = Slot.Serial;
+	return NewHandle;
+}
+
+template<typename ChunkType>
+int32 UHazardSimulationSubsystem::FindOrAddChunk(TArray<ChunkType>& InOutChunks)
+{
+	for (int ChunkIndex = 0; ChunkIndex < InOutChunks.Num(); ChunkIndex++)
+	{
+		if (InOutChunks[ChunkIndex].Num < ChunkType::Capacity)
+		{
+			return ChunkIndex;
+		}
+	}
+
+	const int32 NewChunkIndex = InOutChunks.AddDefaulted();
+	InOutChunks[NewChunkIndex].Init();
+	return NewChunkIndex;
+}
+
+template<typename ChunkType>
+void UHazardSimulationSubsystem::RemoveEntity(TArray<ChunkType>& InOutChunks, const int32 InChunkIndex, const int32 InEntityIndex)
+{
+	ChunkType& Chunk = InOutChunks[InChunkIndex];
+
+	// 핸들 반환
+	FHazardEntitySlot& RemovedSlot = EntitySlots[Chunk.HandleIndices[InEntityIndex]];
+	RemovedSlot.ChunkIndex = INDEX_NONE;
+	RemovedSlot.EntityIndex = INDEX_NONE;
+	FreeEntitySlots.Add(Chunk.HandleIndices[InEntityIndex]);
+
+	// 마지막 엔티티로 채운다.
+	const int32 LastIndex = Chunk.Num - 1;
+	if (InEntityIndex != LastIndex)
+	{
+		Chunk.MoveEntity(LastIndex, InEntityIndex);
+		EntitySlots[Chunk.HandleIndices[InEntityIndex]].EntityIndex = InEntityIndex;
+	}
+
+	Chunk.Casters[LastIndex].Reset();
+	Chunk.Num--;
+}
+
+void UHazardSimulationSubsystem::BuildTargetSnapshot()
+{
+	Targets.Reset();
+	Targets.CellSize = FMath::Max(CVarHazardCellSize.GetValueOnGameThread(), 100.f);
+
+	for (TActorIterator<ACustomCharacter> It(GetWorld()); It; ++It)
+	{
+		ACustomCharacter* Character = *It;
+		if (IsValid(Character) == false || Character->IsDie())
+		{
+			continue;
+		}
+
+		// 물리 쿼리(Overlap, Sweep)에서 걸리지 않는 캡슐은 여기서도 제외
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if (Capsule->IsQueryCollisionEnabled() == false)
+		{
+			continue;
+		}
+
+		uint8 ChannelMask = 0;
+		if (Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1) != ECR_Ignore) ChannelMask |= HazardSimulation::TargetMask_Area;
+		if (Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel12) != ECR_Ignore) ChannelMask |= HazardSimulation::TargetMask_Projectile;
+		if (ChannelMask == 0)
+		{
+			continue;
+		}
+
+		const FVector Location = Capsule->GetComponentLocation();
+		const float Radius = Capsule->GetScaledCapsuleRadius();
+
+		const int32 Slot = Targets.Actors.Add(Character);
+		Targets.Keys.Add(FObjectKey(Character));
+		Targets.Locations.Add(Location);
+		Targets.Radii.Add(Radius);
+		Targets.HalfHeights.Add(Capsule->GetScaledCapsuleHalfHeight());
+		Targets.ChannelMasks.Add(ChannelMask);
+		Targets.MaxRadius = FMath::Max(Targets.MaxRadius, Radius);
+
+		// 중심이 속한 칸에만 넣고, 조회할 때 최대 반지름만큼 넓혀서 찾는다.
+		const FIntPoint Cell(FMath::FloorToInt(Location.X / Targets.CellSize), FMath::FloorToInt(Location.Y / Targets.CellSize));
+		Targets.Cells.FindOrAdd(Cell).Add(Slot);
+	}
+}
+
+template<typename FuncType>
+void UHazardSimulationSubsystem::ForEachTargetInSphere(const FVector& InCenter, const float InRadius, FuncType&& InFunc) const
+{
+	const float QueryRadius = InRadius + Targets.MaxRadius;
+	const int32 MinX = FMath::FloorToInt((InCenter.X - QueryRadius) / Targets.CellSize);
+	const int32 MaxX = FMath::FloorToInt((InCenter.X + QueryRadius) / Targets.CellSize);
+	const int32 MinY = FMath::FloorToInt((InCenter.Y - QueryRadius) / Targets.CellSize);
+	const int32 MaxY = FMath::FloorToInt((InCenter.Y + QueryRadius) / Targets.CellSize);
+
+	for (int32 X = MinX; X <= MaxX; X++)
+	{
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			const TArray<int32, TInlineAllocator<8>>* Cell = Targets.Cells.Find(FIntPoint(X, Y));
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+
+			for (const int32 Slot : *Cell)
+			{
+				if (FVector::DistSquared2D(Targets.Locations[Slot], InCenter) <= FMath::Square(InRadius + Targets.Radii[Slot]) &&
+					FMath::Abs(Targets.Locations[Slot].Z - InCenter.Z) <= InRadius + Targets.HalfHeights[Slot])
+				{
+					InFunc(Slot);
+				}
+			}
+		}
+	}
+}
+
+void UHazardSimulationSubsystem::ProcessAreaChunk(FHazardAreaChunk& InOutChunk, const float InDeltaTime) const
+{
+	InOutChunk.Hits.Reset();
+	InOutChunk.Exits.Reset();
+
+	for (int Index = 0; Index < InOutChunk.Num; Index++)
+	{
+		if (InOutChunk.Expired[Index] == true)
+		{
+			continue;
+		}
+
+		// Lifetime
+		float& ElapsedTime = InOutChunk.ElapsedTimes[Index];
+		ElapsedTime += InDeltaTime;
+		if (InOutChunk.LifeTimes[Index] < ElapsedTime)
+		{
+			InOutChunk.Expired[Index] = true;
+			continue;
+		}
+
+		const float SectionTime = InOutChunk.SectionTimes[Index];
+		const bool bIsDotEffect = SectionTime > 0.f;
+		const FObjectKey CasterKey = InOutChunk.CasterKeys[Index];
+
+		// Overlap
+		TArray<int32, TInlineAllocator<16>> TouchedSlots;
+		for (FHazardAreaPattern& Pattern : InOutChunk.Patterns[Index])
+		{
+			// 패턴은 앞선 패턴의 지연이 끝나야 시작된다.
+			if (ElapsedTime < Pattern.StartTime)
+			{
+				break;
+			}
+
+			if (Pattern.bDone == true)
+			{
+				continue;
+			}
+
+			ForEachTargetInSphere(Pattern.Center, HazardSimulation::GetPatternRadius(Pattern), [&](const int32 Slot)
+			{
+				if (Targets.Keys[Slot] == CasterKey || (Targets.ChannelMasks[Slot] & HazardSimulation::TargetMask_Area) == 0 ||
+					HazardSimulation::IsInsidePattern(Pattern, Targets.Locations[Slot], Targets.Radii[Slot], Targets.HalfHeights[Slot]) == false)
+				{
+					return;
+				}
+
+				if (bIsDotEffect)
+				{
+					// 도트는 모든 패턴을 하나의 장판으로 판정
+					TouchedSlots.AddUnique(Slot);
+				}
+				else
+				{
+					// 도트가 아니면 패턴별로 맞는다.
+					FHazardHit& NewHit = InOutChunk.Hits.AddDefaulted_GetRef();
+					NewHit.EntityIndex = Index;
+					NewHit.TargetSlot = Slot;
+					NewHit.ImpactPoint = Targets.Locations[Slot];
+				}
+			});
+
+			if (bIsDotEffect == false)
+			{
+				Pattern.bDone = true;
+			}
+		}
+
+		// DoT
+		TArray<FHazardDotTimer, TInlineAllocator<4>>& DotTimers = InOutChunk.DotTimers[Index];
+		for (FHazardDotTimer& DotTimer : DotTimers)
+		{
+			DotTimer.bTouched = false;
+		}
+
+		for (const int32 Slot : TouchedSlots)
+		{
+			FHazardDotTimer* DotTimer = DotTimers.FindByPredicate([&](const FHazardDotTimer& Timer) { return Timer.Target == Targets.Keys[Slot]; });
+			if (DotTimer == nullptr)
+			{
+				// 처음 들어온 대상은 바로 맞는다.
+				DotTimer = &DotTimers.AddDefaulted_GetRef();
+				DotTimer->Target = Targets.Keys[Slot];
+				DotTimer->Time = SectionTime;
+			}
+
+			DotTimer->bTouched = true;
+			DotTimer->Time += InDeltaTime;
+			if (SectionTime <= DotTimer->Time)
+			{
+				FHazardHit& NewHit = InOutChunk.Hits.AddDefaulted_GetRef();
+				NewHit.EntityIndex = Index;
+				NewHit.TargetSlot = Slot;
+				NewHit.ImpactPoint = Targets.Locations[Slot];
+
+				DotTimer->Time = 0.f;
+			}
+		}
+
+		// 벗어난 대상 - 컴포넌트 경로와 같이 OnAreaOut 을 보내고, 다시 들어오면 처음 들어온 대상으로 본다.
+		for (int TimerIndex = DotTimers.Num() - 1; TimerIndex >= 0; TimerIndex--)
+		{
+			if (DotTimers[TimerIndex].bTouched == false)
+			{
+				FHazardExit& NewExit = InOutChunk.Exits.AddDefaulted_GetRef();
+				NewExit.EntityIndex = Index;
+				NewExit.Target = DotTimers[TimerIndex].Target;
+
+				DotTimers.RemoveAtSwap(TimerIndex, 1, false);
+			}
+		}
+	}
+}
+
+void UHazardSimulationSubsystem::ProcessProjectileChunk(FHazardProjectileChunk& InOutChunk, const float InDeltaTime) const
+{
+	InOutChunk.Hits.Reset();
+
+	struct FSweepCandidate
+	{
+		int32 Slot = INDEX_NONE;
+		float Time = 0.f;
+		FVector ImpactPoint = FVector::ZeroVector;
+		FVector ImpactNormal = FVector::ZeroVector;
+	};
+
+	TArray<FSweepCandidate, TInlineAllocator<8>> Candidates;
+
+	for (int Index = 0; Index < InOutChunk.Num; Index++)
+	{
+		if (InOutChunk.Expired[Index] == true)
+		{
+			continue;
+		}
+
+		// Lifetime
+		InOutChunk.RemainLifeTimes[Index] -= InDeltaTime;
+		if (InOutChunk.RemainLifeTimes[Index] <= 0.f)
+		{
+			InOutChunk.Expired[Index] = true;
+			continue;
+		}
+
+		if (InOutChunk.FireDelays[Index] > 0.f)
+		{
+			InOutChunk.FireDelays[Index] -= InDeltaTime;
+			continue;
+		}
+
+		// Move
+		const FVector Start = InOutChunk.Locations[Index];
+		FVector& Velocity = InOutChunk.Velocities[Index];
+		const FVector Gravity(0.f, 0.f, InOutChunk.GravityZ[Index]);
+
+		FVector End = Start + Velocity * InDeltaTime + Gravity * (0.5f * InDeltaTime * InDeltaTime);
+		Velocity += Gravity * InDeltaTime;
+
+		float StepDistance = FVector::Dist(Start, End);
+		if (StepDistance >= InOutChunk.RemainDistances[Index])
+		{
+			End = Start + (End - Start) * (InOutChunk.RemainDistances[Index] / FMath::Max(StepDistance, KINDA_SMALL_NUMBER));
+			StepDistance = InOutChunk.RemainDistances[Index];
+			InOutChunk.Expired[Index] = true;
+		}
+
+		InOutChunk.RemainDistances[Index] -= StepDistance;
+		InOutChunk.Locations[Index] = End;
+
+		// Sweep
+		const float SweepRadius = InOutChunk.SweepRadii[Index];
+		const FObjectKey CasterKey = InOutChunk.CasterKeys[Index];
+		TArray<FObjectKey, TInlineAllocator<4>>& HittedTargets = InOutChunk.HittedTargets[Index];
+
+		Candidates.Reset();
+		ForEachTargetInSphere((Start + End) * 0.5f, StepDistance * 0.5f + SweepRadius, [&](const int32 Slot)
+		{
+			if (Targets.Keys[Slot] == CasterKey || (Targets.ChannelMasks[Slot] & HazardSimulation::TargetMask_Projectile) == 0 || HittedTargets.Contains(Targets.Keys[Slot]))
+			{
+				return;
+			}
+
+			FVector CapsuleBottom, CapsuleTop;
+			HazardSimulation::GetCapsuleSegment(Targets.Locations[Slot], Targets.Radii[Slot], Targets.HalfHeights[Slot], CapsuleBottom, CapsuleTop);
+
+			FVector PointOnSweep, PointOnCapsule;
+			FMath::SegmentDistToSegmentSafe(Start, End, CapsuleBottom, CapsuleTop, PointOnSweep, PointOnCapsule);
+			if (FVector::DistSquared(PointOnSweep, PointOnCapsule) > FMath::Square(Targets.Radii[Slot] + SweepRadius))
+			{
+				return;
+			}
+
+			const FVector Normal = (PointOnSweep - PointOnCapsule).GetSafeNormal();
+
+			FSweepCandidate& NewCandidate = Candidates.AddDefaulted_GetRef();
+			NewCandidate.Slot = Slot;
+			NewCandidate.Time = StepDistance > 0.f ? FVector::Dist(Start, PointOnSweep) / StepDistance : 0.f;
+			NewCandidate.ImpactPoint = PointOnCapsule + Normal * Targets.Radii[Slot];
+			NewCandidate.ImpactNormal = Normal;
+		});
+
+		// 가까운 순서, 같으면 스냅샷 순서 (격자 순회 순서와 무관하게 같은 결과)
+		Candidates.Sort([](const FSweepCandidate& A, const FSweepCandidate& B) { return A.Time != B.Time ? A.Time < B.Time : A.Slot < B.Slot; });
+
+		for (const FSweepCandidate& Candidate : Candidates)
+		{
+			FHazardHit& NewHit = InOutChunk.Hits.AddDefaulted_GetRef();
+			NewHit.EntityIndex = Index;
+			NewHit.TargetSlot = Candidate.Slot;
+			NewHit.ImpactPoint = Candidate.ImpactPoint;
+			NewHit.ImpactNormal = Candidate.ImpactNormal;
+
+			// ProcessSweepHits 와 같이 공격 가능 여부와 관계없이 캐릭터에 막힌다.
+			if (InOutChunk.bPierceable[Index] == false)
+			{
+				InOutChunk.Locations[Index] = FMath::Lerp(Start, End, Candidate.Time);
+				InOutChunk.Expired[Index] = true;
+				break;
+			}
+
+			HittedTargets.Add(Targets.Keys[Candidate.Slot]);
+		}
+	}
+}
+
+void UHazardSimulationSubsystem::ApplyAreaHits(FHazardAreaChunk& InOutChunk, const float InDeltaTime)
+{
+	int32 BridgedEntity = INDEX_NONE;
+	UAreaComponent* Bridge = nullptr;
+
+	// 같은 장판의 결과는 연속으로 나오므로 장판이 바뀔 때만 값을 채운다.
+	auto GetBridge = [&](const int32 InEntityIndex)
+	{
+		if (BridgedEntity != InEntityIndex)
+		{
+			Bridge = FindOrAddAreaBridge(InOutChunk.AreaInfos[InEntityIndex].AreaClass);
+			if (Bridge != nullptr) Bridge->InitBridge(InOutChunk.AreaInfos[InEntityIndex]);
+			BridgedEntity = InEntityIndex;
+		}
+
+		return Bridge;
+	};
+
+	for (const FHazardHit& Hit : InOutChunk.Hits)
+	{
+		ACustomCharacter* Target = Targets.Actors[Hit.TargetSlot].Get();
+		if (IsValid(Target) == false || InOutChunk.Casters[Hit.EntityIndex].IsValid() == false)
+		{
+			continue;
+		}
+
+		if (UAreaComponent* HitBridge = GetBridge(Hit.EntityIndex))
+		{
+			HitBridge->OnAreaIn(InDeltaTime, Target, Target->GetCapsuleComponent());
+		}
+	}
+
+	// 시전자가 사라졌어도 들어갈 때 건 효과는 풀어야 하므로 대상만 확인한다.
+	for (const FHazardExit& Exit : InOutChunk.Exits)
+	{
+		ACustomCharacter* Target = Cast<ACustomCharacter>(Exit.Target.ResolveObjectPtr());
+		if (IsValid(Target) == false)
+		{
+			continue;
+		}
+
+		if (UAreaComponent* ExitBridge = GetBridge(Exit.EntityIndex))
+		{
+			ExitBridge->OnAreaOut(InDeltaTime, Target, Target->GetCapsuleComponent());
+		}
+	}
+
+	InOutChunk.Hits.Reset();
+	InOutChunk.Exits.Reset();
+}
+
+void UHazardSimulationSubsystem::ApplyProjectileHits(FHazardProjectileChunk& InOutChunk)
+{
+	ICombatHitPolicy* HitPolicy = UProjectileSubsystem::GetHitPolicy(GetWorld());
+
+	for (const FHazardHit& Hit : InOutChunk.Hits)
+	{
+		ACustomCharacter* Caster = InOutChunk.Casters[Hit.EntityIndex].Get();
+		ACustomCharacter* Target = Targets.Actors[Hit.TargetSlot].Get();
+		const UProjectileArchetype* Archetype = InOutChunk.Archetypes[Hit.EntityIndex];
+		if (IsValid(Caster) == false || IsValid(Target) == false || IsValid(Archetype) == false)
+		{
+			continue;
+		}
+
+		const bool bSimulated = HitPolicy != nullptr && HitPolicy->IsSimulatedCaster(Caster);
+		if (ACustomProjectileActor::CheckAttackable(HitPolicy, bSimulated, Caster, Target) == false)
+		{
+			continue;
+		}
+
+		FHitResult HitResult(Target, Target->GetCapsuleComponent(), Hit.ImpactPoint, Hit.ImpactNormal);
+		HitResult.bBlockingHit = true;
+		HitResult.ImpactPoint = Hit.ImpactPoint;
+		HitResult.ImpactNormal = Hit.ImpactNormal;
+
+		ACustomProjectileActor::SendHit(Caster, bSimulated, Archetype->GetProjectileInfo(), InOutChunk.Origins[Hit.EntityIndex], HitResult);
+	}
+
+	InOutChunk.Hits.Reset();
+}
+
+void UHazardSimulationSubsystem::RemoveExpired()
+{
+	for (int ChunkIndex = 0; ChunkIndex < AreaChunks.Num(); ChunkIndex++)
+	{
+		for (int Index = AreaChunks[ChunkIndex].Num - 1; Index >= 0; Index--)
+		{
+			if (AreaChunks[ChunkIndex].Expired[Index] == true)
+			{
+				RemoveEntity(AreaChunks, ChunkIndex, Index);
+				NumAreas--;
+			}
+		}
+	}
+
+	for (int ChunkIndex = 0; ChunkIndex < ProjectileChunks.Num(); ChunkIndex++)
+	{
+		for (int Index = ProjectileChunks[ChunkIndex].Num - 1; Index >= 0; Index--)
+		{
+			if (ProjectileChunks[ChunkIndex].Expired[Index] == true)
+			{
+				RemoveEntity(ProjectileChunks, ChunkIndex, Index);
+				NumProjectiles--;
+			}
+		}
+	}
+}
+
+UAreaComponent* UHazardSimulationSubsystem::FindOrAddAreaBridge(TSubclassOf<UAreaComponent> InAreaClass)
+{
+	if (InAreaClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	UAreaComponent*& Bridge = AreaBridges.FindOrAdd(InAreaClass);
+	if (IsValid(Bridge) == false)
+	{
+		Bridge = NewObject<UAreaComponent>(this, InAreaClass, NAME_None, RF_Transient);
+	}
+
+	return Bridge;
+}
@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "UObject/ObjectKey.h"
+#include "ProjectileSubsystem.h"
+#include "HazardSimulationSubsystem.generated.h"
+
+class UAreaComponent;
+class UProjectileArchetype;
+
+/** 하자드 엔티티 핸들. 슬롯이 재사용되어도 Serial 로 구분한다. */
+struct FHazardHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	inline bool IsSet() const { return Index != INDEX_NONE; }
+	inline bool operator==(const FHazardHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+};
+
+/** 장판 패턴 하나의 판정 모양 (FAreaOverlapInfo 중 판정에 필요한 값만) */
+struct FHazardAreaPattern
+{
+	ECollisionSweepShapeType ShapeType = ECollisionSweepShapeType::Shpere;
+	FVector Center = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Dir = FVector::ForwardVector;
+	FVector Extent = FVector::OneVector;
+	float RingWidth = 0.f;
+	float SectorAngle = 0.f;
+
+	/** 판정 시작 시점 (CollisionCheckDelay + 앞선 패턴 지연 누적) */
+	float StartTime = 0.f;
+
+	/** 도트가 아닌 장판은 패턴마다 한 번만 판정 */
+	bool bDone = false;
+};
+
+struct FHazardDotTimer
+{
+	FObjectKey Target;
+	float Time = 0.f;
+
+	/** 이번 틱에 장판 안에 있었는지. 아니면 타이머를 지우고 OnAreaOut 을 보낸다. */
+	bool bTouched = false;
+};
+
+/** 워커 스레드의 판정 결과. 게임 스레드에서 청크 순서대로 적용한다. */
+struct FHazardHit
+{
+	int32 EntityIndex = INDEX_NONE;	// 청크 안의 인덱스
+	int32 TargetSlot = INDEX_NONE;	// 캐릭터 스냅샷 인덱스
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::ZeroVector;
+};
+
+/** 도트 장판에서 벗어난 대상. 스냅샷에서 빠졌을 수 있으므로 키로 남긴다. */
+struct FHazardExit
+{
+	int32 EntityIndex = INDEX_NONE;
+	FObjectKey Target;
+};
+
+/**
+ * 청크 공통. 엔티티는 청크 안에서 빈틈 없이 유지되며 제거시 마지막 엔티티를 옮겨 채운다.
+ * 프래그먼트마다 배열을 따로 두어 처리기가 필요한 값만 연속으로 읽도록 한다.
+ */
+struct FHazardChunkBase
+{
+	static constexpr int32 Capacity = 128;
+
+	int32 Num = 0;
+
+	/** Entity */
+	TArray<int32> HandleIndices;
+	TArray<TWeakObjectPtr<ACustomCharacter>> Casters;
+	TArray<FObjectKey> CasterKeys;
+
+	/** 처리기 출력 */
+	TArray<bool> Expired;
+	TArray<FHazardHit> Hits;
+
+	void Init();
+	void MoveEntity(const int32 InFrom, const int32 InTo);
+};
+
+struct FHazardAreaChunk : public FHazardChunkBase
+{
+	/** Transform - 모든 패턴을 감싸는 구 (광역 판정용) */
+	TArray<FVector> BoundsCenters;
+	TArray<float> BoundsRadii;
+
+	/** Shape */
+	TArray<TArray<FHazardAreaPattern, TInlineAllocator<2>>> Patterns;
+
+	/** Timeline */
+	TArray<float> ElapsedTimes;
+	TArray<float> LifeTimes;
+	TArray<float> SectionTimes;		// 0 이면 도트 아님
+
+	/** Hit state */
+	TArray<TArray<FHazardDotTimer, TInlineAllocator<4>>> DotTimers;
+
+	/** 처리기 출력 - OnAreaOut */
+	TArray<FHazardExit> Exits;
+
+	/** Bridge - OnAreaIn, OnAreaOut 호출용 (판정 처리기는 읽지 않음) */
+	TArray<FSkillAreaInfo> AreaInfos;
+
+	void Init();
+	void MoveEntity(const int32 InFrom, const int32 InTo);
+};
+
+struct FHazardProjectileChunk : public FHazardChunkBase
+{
+	/** Transform */
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+
+	/** Shape */
+	TArray<float> SweepRadii;
+
+	/** Timeline */
+	TArray<float> FireDelays;
+	TArray<float> RemainDistances;
+	TArray<float> RemainLifeTimes;
+
+	/** Hit state */
+	TArray<TArray<FObjectKey, TInlineAllocator<4>>> HittedTargets;
+	TArray<bool> bPierceable;
+
+	/** Bridge - OnSend_Hit_Skill 호출용 */
+	TArray<UProjectileArchetype*> Archetypes;
+	TArray<FVector> Origins;
+
+	void Init();
+	void MoveEntity(const int32 InFrom, const int32 InTo);
+};
+
+/**
+ * 대규모 전투용 하자드(장판, 발사체) 시뮬레이션.
+ * 컴포넌트나 액터 없이 청크 단위 SoA 로 보관하고, 판정은 캐릭터 캡슐 스냅샷에 대해 청크별로 병렬 처리한다.
+ * 결과는 게임 스레드에서 기존 OnAreaIn, OnAreaOut(도트 장판), OnSend_Hit_Skill 경로로 넘긴다.
+ *
+ * 일반 콘텐츠는 계속 UAreaComponent, ACustomProjectileActor 를 쓴다.
+ * 캐릭터만 판정하며 지형, 오브젝트와는 충돌하지 않는다. 표시(데칼, 파티클, 사운드)도 하지 않는다.
+ */
+UCLASS()
+class UHazardSimulationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false && (NumAreas > 0 || NumProjectiles > 0); }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UHazardSimulationSubsystem, STATGROUP_Tickables); }
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/** Spawn (서버 전용) */
+	FHazardHandle SpawnArea(const FSkillAreaInfo& InAreaInfo);
+	FHazardHandle SpawnProjectile(const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo);
+
+	void Despawn(const FHazardHandle InHandle);
+	bool IsAlive(const FHazardHandle InHandle) const;
+
+	inline int32 GetNumAreas() const { return NumAreas; }
+	inline int32 GetNumProjectiles() const { return NumProjectiles; }
+
+private:
+	enum class EHazardKind : uint8
+	{
+		Area,
+		Projectile,
+	};
+
+	/** 핸들 슬롯 -> 청크 위치 */
+	struct FHazardEntitySlot
+	{
+		EHazardKind Kind = EHazardKind::Area;
+		int32 ChunkIndex = INDEX_NONE;
+		int32 EntityIndex = INDEX_NONE;
+		uint32 Serial = 0;
+	};
+
+	FHazardHandle AllocateHandle(const EHazardKind InKind, const int32 InChunkIndex, const int32 InEntityIndex);
+
+	template<typename ChunkType>
+	int32 FindOrAddChunk(TArray<ChunkType>& InOutChunks);
+
+	template<typename ChunkType>
+	void RemoveEntity(TArray<ChunkType>& InOutChunks, const int32 InChunkIndex, const int32 InEntityIndex);
+
+	/** Processors */
+	void BuildTargetSnapshot();
+	void ProcessAreaChunk(FHazardAreaChunk& InOutChunk, const float InDeltaTime) const;
+	void ProcessProjectileChunk(FHazardProjectileChunk& InOutChunk, const float InDeltaTime) const;
+
+	/** Game thread */
+	void ApplyAreaHits(FHazardAreaChunk& InOutChunk, const float InDeltaTime);
+	void ApplyProjectileHits(FHazardProjectileChunk& InOutChunk);
+	void RemoveExpired();
+
+	UAreaComponent* FindOrAddAreaBridge(TSubclassOf<UAreaComponent> InAreaClass);
+
+	/** 스냅샷 격자에서 구와 닿을 수 있는 캐릭터를 찾는다. */
+	template<typename FuncType>
+	void ForEachTargetInSphere(const FVector& InCenter, const float InRadius, FuncType&& InFunc) const;
+
+private:
+	/** Chunks */
+	TArray<FHazardAreaChunk> AreaChunks;
+	TArray<FHazardProjectileChunk> ProjectileChunks;
+	int32 NumAreas = 0;
+	int32 NumProjectiles = 0;
+
+	/** Handles */
+	TArray<FHazardEntitySlot> EntitySlots;
+	TArray<int32> FreeEntitySlots;
+
+	/** 캐릭터 캡슐 스냅샷 (틱마다 게임 스레드에서 갱신, 처리기는 읽기만) */
+	struct FHazardTargetSnapshot
+	{
+		TArray<TWeakObjectPtr<ACustomCharacter>> Actors;
+		TArray<FObjectKey> Keys;
+		TArray<FVector> Locations;
+		TArray<float> Radii;
+		TArray<float> HalfHeights;
+
+		/** 캡슐이 무시하지 않는 판정 채널 (HazardSimulation::TargetMask_*) */
+		TArray<uint8> ChannelMasks;
+		float MaxRadius = 0.f;
+
+		float CellSize = 1000.f;
+		TMap<FIntPoint, TArray<int32, TInlineAllocator<8>>> Cells;
+
+		void Reset();
+	};
+
+	FHazardTargetSnapshot Targets;
+
+	/** AreaClass 별로 OnAreaIn, OnAreaOut 을 대신 받을 컴포넌트 (등록하지 않음) */
+	UPROPERTY()
+	TMap<TSubclassOf<UAreaComponent>, UAreaComponent*> AreaBridges;
+};
@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HitboxHistory.h"
+#include "Components/CapsuleComponent.h"
+#include "EngineUtils.h"
+
+static TAutoConsoleVariable<int32> CVarHitboxHistoryFrames(
+	TEXT("Projectile.LagComp.HistoryFrames"),
+	32,
+	TEXT("Number of frames kept in the server hitbox history. Applied on next history reset."),
+	ECVF_Default);
+
+void FHitboxHistory::Sample(UWorld* InWorld, const double InTime)
+{
+	if (IsValid(InWorld) == false)
+	{
+		return;
+	}
+
+	if (FrameTimes.Num() == 0)
+	{
+		const int32 Capacity = FMath::Max(CVarHitboxHistoryFrames.GetValueOnGameThread(), 2);
+		FrameTimes.SetNumZeroed(Capacity);
+		FrameSerials.SetNumZeroed(Capacity);
+		GrowSlots(FMath::Max(MaxSlots, 16));
+	}
+
+	const int32 Capacity = FrameTimes.Num();
+	HeadFrame = (HeadFrame + 1) % Capacity;
+	NumFrames = FMath::Min(NumFrames + 1, Capacity);
+
+	const uint32 FrameSerial = NextFrameSerial++;
+	FrameTimes[HeadFrame] = InTime;
+	FrameSerials[HeadFrame] = FrameSerial;
+
+	// 사라진 캐릭터 슬롯 반환
+	for (int32 Slot = 0; Slot < SlotActors.Num(); Slot++)
+	{
+		if (SlotFirstSerial[Slot] != 0 && SlotActors[Slot].IsValid() == false)
+		{
+			ActorToSlot.Remove(SlotKeys[Slot]);
+			SlotActors[Slot].Reset();
+			SlotFirstSerial[Slot] = 0;
+			FreeSlots.Add(Slot);
+		}
+	}
+
+	for (TActorIterator<ACustomCharacter> It(InWorld); It; ++It)
+	{
+		ACustomCharacter* Character = *It;
+		if (IsValid(Character) == false)
+		{
+			continue;
+		}
+
+		const int32 Slot = FindOrAddSlot(Character);
+		if (SlotFirstSerial[Slot] == 0)
+		{
+			SlotFirstSerial[Slot] = FrameSerial;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		const FVector Location = Capsule->GetComponentLocation();
+
+		const int32 PosIndex = GetPosIndex(HeadFrame, Slot);
+		PosX[PosIndex] = Location.X;
+		PosY[PosIndex] = Location.Y;
+		PosZ[PosIndex] = Location.Z;
+
+		// 물리 스윕(SweepMultiByChannel)은 Overlap 도 반환하므로 Ignore 만 제외
+		Hittable[PosIndex] = Character->IsDie() == false &&
+			Capsule->IsQueryCollisionEnabled() == true &&
+			Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel12) != ECR_Ignore;
+
+		SlotRadius[Slot] = Capsule->GetScaledCapsuleRadius();
+		SlotHalfHeight[Slot] = Capsule->GetScaledCapsuleHalfHeight();
+	}
+}
+
+void FHitboxHistory::Reset()
+{
+	FrameTimes.Empty();
+	FrameSerials.Empty();
+	NumFrames = 0;
+	HeadFrame = INDEX_NONE;
+
+	PosX.Empty();
+	PosY.Empty();
+	PosZ.Empty();
+	Hittable.Empty();
+	MaxSlots = 0;
+
+	SlotActors.Empty();
+	SlotKeys.Empty();
+	SlotRadius.Empty();
+	SlotHalfHeight.Empty();
+	SlotFirstSerial.Empty();
+	FreeSlots.Empty();
+	ActorToSlot.Empty();
+}
+
+void FHitboxHistory::SweepAtTime(const double InTime, const FVector& InStart, const FVector& InEnd, const float InRadius, TFunctionRef<bool(const AActor*)> InIgnorePred, TArray<FHitResult>& OutHits) const
+{
+	int32 OlderFrame = INDEX_NONE;
+	int32 NewerFrame = INDEX_NONE;
+	float Alpha = 0.f;
+	if (FindFrames(InTime, OlderFrame, NewerFrame, Alpha) == false)
+	{
+		return;
+	}
+
+	const uint32 OlderSerial = FrameSerials[OlderFrame];
+	const float SegmentLength = FVector::Dist(InStart, InEnd);
+	const FVector BoundsMin = InStart.ComponentMin(InEnd) - FVector(InRadius);
+	const FVector BoundsMax = InStart.ComponentMax(InEnd) + FVector(InRadius);
+
+	const int32 OlderBase = GetPosIndex(OlderFrame, 0);
+	const int32 NewerBase = GetPosIndex(NewerFrame, 0);
+
+	for (int32 Slot = 0; Slot < SlotActors.Num(); Slot++)
+	{
+		if (SlotFirstSerial[Slot] == 0 || SlotFirstSerial[Slot] > OlderSerial)
+		{
+			continue;
+		}
+
+		// 앞뒤 프레임 중 하나라도 판정 대상이 아니면 제외 (사망, 충돌 끔)
+		if (Hittable[OlderBase + Slot] == 0 || Hittable[NewerBase + Slot] == 0)
+		{
+			continue;
+		}
+
+		const float Radius = SlotRadius[Slot];
+		const float HalfHeight = SlotHalfHeight[Slot];
+		const float X = FMath::Lerp(PosX[OlderBase + Slot], PosX[NewerBase + Slot], Alpha);
+		const float Y = FMath::Lerp(PosY[OlderBase + Slot], PosY[NewerBase + Slot], Alpha);
+		const float Z = FMath::Lerp(PosZ[OlderBase + Slot], PosZ[NewerBase + Slot], Alpha);
+
+		// AABB 로 먼저 거른다.
+		if (X + Radius < BoundsMin.X || X - Radius > BoundsMax.X ||
+			Y + Radius < BoundsMin.Y || Y - Radius > BoundsMax.Y ||
+			Z + HalfHeight < BoundsMin.Z || Z - HalfHeight > BoundsMax.Z)
+		{
+			continue;
+		}
+
+		AActor* Actor = SlotActors[Slot].Get();
+		if (Actor == nullptr || InIgnorePred(Actor))
+		{
+			continue;
+		}
+
+		const float SegmentHalfHeight = FMath::Max(HalfHeight - Radius, 0.f);
+		const FVector CapsuleBottom(X, Y, Z - SegmentHalfHeight);
+		const FVector CapsuleTop(X, Y, Z + SegmentHalfHeight);
+
+		FVector PointOnSweep;
+		FVector PointOnCapsule;
+		FMath::SegmentDistToSegmentSafe(InStart, InEnd, CapsuleBottom, CapsuleTop, PointOnSweep, PointOnCapsule);
+
+		if (FVector::DistSquared(PointOnSweep, PointOnCapsule) > FMath::Square(Radius + InRadius))
+		{
+			continue;
+		}
+
+		const FVector Normal = (PointOnSweep - PointOnCapsule).GetSafeNormal();
+
+		FHitResult NewHit(Actor, nullptr, PointOnSweep, Normal);
+		NewHit.bBlockingHit = true;
+		NewHit.Time = SegmentLength > 0.f ? FVector::Dist(InStart, PointOnSweep) / SegmentLength : 0.f;
+		NewHit.TraceStart = InStart;
+		NewHit.TraceEnd = InEnd;
+		NewHit.ImpactPoint = PointOnCapsule + Normal * Radius;
+		NewHit.ImpactNormal = Normal;
+
+		OutHits.Emplace(NewHit);
+	}
+}
+
+bool FHitboxHistory::IsTracked(const AActor* InActor) const
+{
+	return InActor != nullptr && ActorToSlot.Contains(FObjectKey(InActor));
+}
+
+int32 FHitboxHistory::FindOrAddSlot(AActor* InActor)
+{
+	const FObjectKey ActorKey(InActor);
+	if (const int32* FoundSlot = ActorToSlot.Find(ActorKey))
+	{
+		return *FoundSlot;
+	}
+
+	int32 NewSlot = INDEX_NONE;
+	if (FreeSlots.Num() > 0)
+	{
+		NewSlot = FreeSlots.Pop();
+	}
+	else
+	{
+		NewSlot = SlotActors.AddDefaulted();
+		SlotKeys.AddDefaulted();
+		SlotRadius.AddZeroed();
+		SlotHalfHeight.AddZeroed();
+		SlotFirstSerial.AddZeroed();
+
+		if (SlotActors.Num() > MaxSlots)
+		{
+			GrowSlots(MaxSlots * 2);
+		}
+	}
+
+	SlotActors[NewSlot] = InActor;
+	SlotKeys[NewSlot] = ActorKey;
+	SlotFirstSerial[NewSlot] = 0;
+	ActorToSlot.Add(ActorKey, NewSlot);
+
+	return NewSlot;
+}
+
+void FHitboxHistory::GrowSlots(const int32 InNewMaxSlots)
+{
+	const int32 Capacity = FrameTimes.Num();
+	if (InNewMaxSlots <= MaxSlots || Capacity == 0)
+	{
+		MaxSlots = FMath::Max(MaxSlots, InNewMaxSlots);
+		return;
+	}
+
+	TArray<float> NewPosX, NewPosY, NewPosZ;
+	TArray<uint8> NewHittable;
+	NewPosX.SetNumZeroed(Capacity * InNewMaxSlots);
+	NewPosY.SetNumZeroed(Capacity * InNewMaxSlots);
+	NewPosZ.SetNumZeroed(Capacity * InNewMaxSlots);
+	NewHittable.SetNumZeroed(Capacity * InNewMaxSlots);
+
+	for (int32 Frame = 0; Frame < Capacity && MaxSlots > 0; Frame++)
+	{
+		FMemory::Memcpy(&NewPosX[Frame * InNewMaxSlots], &PosX[Frame * MaxSlots], MaxSlots * sizeof(float));
+		FMemory::Memcpy(&NewPosY[Frame * InNewMaxSlots], &PosY[Frame * MaxSlots], MaxSlots * sizeof(float));
+		FMemory::Memcpy(&NewPosZ[Frame * InNewMaxSlots], &PosZ[Frame * MaxSlots], MaxSlots * sizeof(float));
+		FMemory::Memcpy(&NewHittable[Frame * InNewMaxSlots], &Hittable[Frame * MaxSlots], MaxSlots * sizeof(uint8));
+	}
+
+	PosX = MoveTemp(NewPosX);
+	PosY = MoveTemp(NewPosY);
+	PosZ = MoveTemp(NewPosZ);
+	Hittable = MoveTemp(NewHittable);
+	MaxSlots = InNewMaxSlots;
+}
+
+bool FHitboxHistory::FindFrames(const double InTime, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const
+{
+	if (NumFrames == 0)
+	{
+		return false;
+	}
+
+	const int32 Capacity = FrameTimes.Num();
+
+	int32 NewerFrame = HeadFrame;
+	for (int32 Age = 0; Age < NumFrames; Age++)
+	{
+		const int32 Frame = (HeadFrame - Age + Capacity) % Capacity;
+		if (FrameTimes[Frame] <= InTime)
+		{
+			OutOlderFrame = Frame;
+			OutNewerFrame = NewerFrame;
+
+			const double Span = FrameTimes[NewerFrame] - FrameTimes[Frame];
+			OutAlpha = Span > 0.0 ? (float)((InTime - FrameTimes[Frame]) / Span) : 0.f;
+			return true;
+		}
+
+		NewerFrame = Frame;
+	}
+
+	// 기록보다 오래된 시점은 가장 오래된 프레임으로 판정
+	OutOlderFrame = NewerFrame;
+	OutNewerFrame = NewerFrame;
+	OutAlpha = 0.f;
+	return true;
+}
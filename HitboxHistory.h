@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UWorld;
+class AActor;
+
+/**
+ * 서버 캐릭터 캡슐 위치 기록 (지연 보상용).
+ * 프레임 단위 링버퍼이며, 한 프레임의 모든 캐릭터 위치가 연속되도록 SoA 로 저장한다.
+ * 물리 씬은 건드리지 않고 되감은 위치에 대해 직접 캡슐 판정을 한다.
+ * 죽었거나 캡슐이 ECC_GameTraceChannel12 를 무시하는 프레임은 판정하지 않는다. (물리 스윕과 같은 기준)
+ */
+class FHitboxHistory
+{
+public:
+	void Sample(UWorld* InWorld, const double InTime);
+	void Reset();
+
+	/**
+	 * InTime 시점의 캡슐 위치로 구(반지름 InRadius) 스윕 판정을 해서 OutHits 에 추가한다.
+	 * 결과의 Time 은 InStart~InEnd 구간 비율
+	 */
+	void SweepAtTime(const double InTime, const FVector& InStart, const FVector& InEnd, const float InRadius, TFunctionRef<bool(const AActor*)> InIgnorePred, TArray<FHitResult>& OutHits) const;
+
+	/** 기록 중인 캐릭터인지 (물리 판정 결과에서 제외할 대상) */
+	bool IsTracked(const AActor* InActor) const;
+
+	inline int32 GetNumSlots() const { return SlotActors.Num(); }
+
+private:
+	int32 FindOrAddSlot(AActor* InActor);
+	void GrowSlots(const int32 InNewMaxSlots);
+
+	/** InTime 을 감싸는 두 프레임. 기록이 부족하면 false */
+	bool FindFrames(const double InTime, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const;
+
+	inline int32 GetPosIndex(const int32 InFrame, const int32 InSlot) const { return InFrame * MaxSlots + InSlot; }
+
+private:
+	/** Frame ring */
+	TArray<double> FrameTimes;
+	TArray<uint32> FrameSerials;
+	int32 NumFrames = 0;
+	int32 HeadFrame = INDEX_NONE;
+	uint32 NextFrameSerial = 1;
+
+	/** Positions [Frame * MaxSlots + Slot] */
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+	TArray<uint8> Hittable;
+	int32 MaxSlots = 0;
+
+	/** Slots */
+	TArray<TWeakObjectPtr<AActor>> SlotActors;
+	TArray<FObjectKey> SlotKeys;
+	TArray<float> SlotRadius;
+	TArray<float> SlotHalfHeight;
+	TArray<uint32> SlotFirstSerial;	// 이 시리얼 이전 프레임의 위치는 유효하지 않다.
+	TArray<int32> FreeSlots;
+	TMap<FObjectKey, int32> ActorToSlot;
+};
@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileArchetype.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/PointLightComponent.h"
+#include "Components/AudioComponent.h"
+#include "CustomParticleSystemComponent.h"
+#include "CustomSkeletalMeshComponent.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleEmitter.h"
+#include "Serialization/ArchiveUObject.h"
+
+namespace ProjectileArchetype
+{
+	/** 바이너리 직렬화 결과를 바로 CRC 에 넣는다. 에셋은 포인터, 이름은 이름 해시로 */
+	class FCompiledFieldHasher : public FArchiveUObject
+	{
+	public:
+		FCompiledFieldHasher()
+		{
+			SetIsSaving(true);
+		}
+
+		virtual void Serialize(void* Data, int64 Num) override
+		{
+			Hash = FCrc::MemCrc32(Data, (int32)Num, Hash);
+		}
+
+		virtual FArchive& operator<<(UObject*& Value) override
+		{
+			UPTRINT Address = (UPTRINT)Value;
+			Serialize(&Address, sizeof(Address));
+			return *this;
+		}
+
+		virtual FArchive& operator<<(FName& Value) override
+		{
+			uint32 NameHash = GetTypeHash(Value);
+			Serialize(&NameHash, sizeof(NameHash));
+			return *this;
+		}
+
+		inline uint32 GetHash() const { return Hash; }
+
+	private:
+		uint32 Hash = 0;
+	};
+}
+
+void UProjectileArchetype::Compile(const FSkillProjectileInfo& InProjectileInfo, const bool bInWithVisual)
+{
+	ProjectileInfo = InProjectileInfo;
+
+	// 발사별 값은 원형에 남기지 않는다.
+	ClearPerShotFields(ProjectileInfo);
+
+	// LifeTime
+	MaxMoveDistance = InProjectileInfo.ProjectileMaxMoveDistance - InProjectileInfo.CollisionExtent.X;
+	TravelTime = InProjectileInfo.ProjectileSpeed > 0.f ? MaxMoveDistance / InProjectileInfo.ProjectileSpeed : 0.f;
+
+	// Sweep shape
+	SweepShapeRotation = FQuat::Identity;
+
+	if (InProjectileInfo.CollisionShape == ECollisionSweepShapeType::Shpere)
+	{
+		SweepShape = FCollisionShape::MakeSphere(InProjectileInfo.CollisionExtent.X);
+	}
+	else if (InProjectileInfo.CollisionShape == ECollisionSweepShapeType::Box)
+	{
+		SweepShape = FCollisionShape::MakeBox(InProjectileInfo.CollisionExtent);
+	}
+	else if (InProjectileInfo.CollisionShape == ECollisionSweepShapeType::Capsule)
+	{
+		SweepShape = FCollisionShape::MakeCapsule(InProjectileInfo.CollisionExtent.Y, InProjectileInfo.CollisionExtent.X);
+		SweepShapeRotation = FQuat(FRotator(90.f, 0.f, 0.f));
+	}
+
+	CompileCollision();
+
+#if !UE_SERVER
+	if (bInWithVisual == true)
+	{
+		CompileMesh();
+		CompileLight();
+		CompileParticle();
+		CompileSound();
+	}
+#endif
+}
+
+uint32 UProjectileArchetype::HashCompiledFields(const FSkillProjectileInfo& InProjectileInfo)
+{
+	// 원형에 남는 복사본(Compile 과 같은 값)을 통째로 해시해서, 원형을 읽는 쪽이 새 필드를 쓰더라도 해시에서 빠지지 않게 한다.
+	FSkillProjectileInfo CompiledInfo = InProjectileInfo;
+	ClearPerShotFields(CompiledInfo);
+
+	ProjectileArchetype::FCompiledFieldHasher Hasher;
+	FSkillProjectileInfo::StaticStruct()->SerializeBin(Hasher, &CompiledInfo);
+	return Hasher.GetHash();
+}
+
+void UProjectileArchetype::ClearPerShotFields(FSkillProjectileInfo& InOutProjectileInfo)
+{
+	InOutProjectileInfo.Caster = nullptr;
+	InOutProjectileInfo.Target = nullptr;
+	InOutProjectileInfo.Angle = 0.f;
+	InOutProjectileInfo.FireDelay = 0.f;
+}
+
+float UProjectileArchetype::GetLifeSpan(const float InFireDelay) const
+{
+	const float BaseLifeSpan = ProjectileInfo.UseLifeTime ? ProjectileInfo.InitialLifeSpan + InFireDelay : 0.f;
+	const float LifeTimeByDist = TravelTime + InFireDelay;
+	return LifeTimeByDist <= 0.f ? BaseLifeSpan : LifeTimeByDist; // MaxDistance가 BaseLifeSpan보다 우선순위가 높다.
+}
+
+void UProjectileArchetype::CompileCollision()
+{
+	switch (ProjectileInfo.CollisionShape)
+	{
+	case ECollisionSweepShapeType::Box:
+	{
+		UBoxComponent* InNewBoxComp = NewObject<UBoxComponent>(this, UBoxComponent::StaticClass(), NAME_None, RF_Transient);
+		if (IsValid(InNewBoxComp)) InNewBoxComp->SetBoxExtent(ProjectileInfo.CollisionExtent);
+		CollisionTemplate = InNewBoxComp;
+		break;
+	}
+	case ECollisionSweepShapeType::Capsule:
+	{
+		UCapsuleComponent* InNewCapsuleComp = NewObject<UCapsuleComponent>(this, UCapsuleComponent::StaticClass(), NAME_None, RF_Transient);
+		if (IsValid(InNewCapsuleComp)) InNewCapsuleComp->SetCapsuleSize(ProjectileInfo.CollisionExtent.Z, FMath::Max(ProjectileInfo.CollisionExtent.X, ProjectileInfo.CollisionExtent.Y));
+		CollisionTemplate = InNewCapsuleComp;
+		break;
+	}
+	case ECollisionSweepShapeType::Shpere:
+	{
+		USphereComponent* InNewSphereComp = NewObject<USphereComponent>(this, USphereComponent::StaticClass(), NAME_None, RF_Transient);
+		if (IsValid(InNewSphereComp)) InNewSphereComp->SetSphereRadius(FMath::Max(ProjectileInfo.CollisionExtent.X, ProjectileInfo.CollisionExtent.Y));
+		CollisionTemplate = InNewSphereComp;
+		break;
+	}
+	}
+
+	if (CollisionTemplate != nullptr)
+	{
+		CollisionTemplate->BodyInstance.SetCollisionProfileName(TEXT("Projectile"));
+		CollisionTemplate->bShouldCollideWhenPlacing = true;
+		CollisionTemplate->SetRelativeTransform(ProjectileInfo.CollisionTM);
+	}
+}
+
+void UProjectileArchetype::CompileMesh()
+{
+	if (ProjectileInfo.ProjectileSkeletalMesh == nullptr)
+	{
+		return;
+	}
+
+	MeshTemplate = NewObject<UCustomSkeletalMeshComponent>(this, NAME_None, RF_Transient);
+	if (MeshTemplate)
+	{
+		MeshTemplate->SetVisibility(false);
+		MeshTemplate->SetSkeletalMesh(ProjectileInfo.ProjectileSkeletalMesh);
+		MeshTemplate->SetRelativeTransform(ProjectileInfo.ProjectileSkeletalMeshTM);
+	}
+}
+
+void UProjectileArchetype::CompileLight()
+{
+	if (ProjectileInfo.UsePointLight == false)
+	{
+		return;
+	}
+
+	LightTemplate = NewObject<UPointLightComponent>(this, NAME_None, RF_Transient);
+	if (LightTemplate)
+	{
+		LightTemplate->SetVisibility(false);
+		LightTemplate->SetMobility(EComponentMobility::Movable);
+		LightTemplate->SetLightColor(ProjectileInfo.LightColor);
+		LightTemplate->SetAttenuationRadius(ProjectileInfo.AttenuationRadius);
+		LightTemplate->SetIntensity(ProjectileInfo.Insensity);
+		LightTemplate->SetCastShadows(false); // 그림자는 FProjectileLightManager 가 예산 안에서만 켠다.
+	}
+}
+
+void UProjectileArchetype::CompileParticle()
+{
+	if (ProjectileInfo.ProjectileParticle == nullptr)
+	{
+		return;
+	}
+
+	ParticleTemplate = NewObject<UCustomParticleSystemComponent>(this, NAME_None, RF_Transient);
+	if (ParticleTemplate)
+	{
+		ParticleTemplate->bAutoActivate = false;
+		ParticleTemplate->bNeverDistanceCull = true;
+		ParticleTemplate->SetTemplate(ProjectileInfo.ProjectileParticle);
+		ParticleTemplate->SetRelativeTransform(ProjectileInfo.ProjectileParticleTM);
+	}
+
+	// EmitterInstances 는 템플릿의 Emitters 와 같은 순서로 만들어진다.
+	const TArray<UParticleEmitter*>& Emitters = ProjectileInfo.ProjectileParticle->Emitters;
+	for (int32 Index = 0; Index < Emitters.Num(); Index++)
+	{
+		if (IsValid(Emitters[Index]) && ProjectileInfo.EmitterNameToDisableOnHit.Contains(Emitters[Index]->EmitterName))
+		{
+			EmitterIndicesToDisableOnHit.Add(Index);
+		}
+	}
+}
+
+void UProjectileArchetype::CompileSound()
+{
+	for (const FSoundInfo& SoundInfo : ProjectileInfo.SoundInfo)
+	{
+		// 발사체의 AudioComponents 인덱스와 SoundInfo 인덱스를 맞추기 위해 실패해도 자리를 채운다.
+		UAudioComponent* SoundTemplate = NewObject<UAudioComponent>(this, NAME_None, RF_Transient);
+		if (SoundTemplate)
+		{
+			SoundTemplate->bAutoActivate = false;
+			SoundTemplate->SetSound(SoundInfo.SoundBase);
+			SoundTemplate->SetRelativeTransform(SoundInfo.SoundTM);
+		}
+
+		SoundTemplates.Add(SoundTemplate);
+	}
+}
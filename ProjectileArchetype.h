@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "CollisionShape.h"
+#include "ProjectileArchetype.generated.h"
+
+class UShapeComponent;
+class UCustomSkeletalMeshComponent;
+class UCustomParticleSystemComponent;
+class UPointLightComponent;
+class UAudioComponent;
+
+USTRUCT()
+struct FProjectileArchetypeKey
+{
+	GENERATED_BODY()
+
+public:
+	FProjectileArchetypeKey() {}
+	FProjectileArchetypeKey(const FName InSkillCID, const int32 InAttackDamageIndex, const uint32 InCompiledHash)
+		: SkillCID(InSkillCID), AttackDamageIndex(InAttackDamageIndex), CompiledHash(InCompiledHash) {}
+
+	inline bool operator==(const FProjectileArchetypeKey& Other) const
+	{
+		return SkillCID == Other.SkillCID && AttackDamageIndex == Other.AttackDamageIndex && CompiledHash == Other.CompiledHash;
+	}
+
+	friend inline uint32 GetTypeHash(const FProjectileArchetypeKey& InKey)
+	{
+		return HashCombine(HashCombine(GetTypeHash(InKey.SkillCID), GetTypeHash(InKey.AttackDamageIndex)), InKey.CompiledHash);
+	}
+
+public:
+	FName SkillCID = NAME_None;
+	int32 AttackDamageIndex = 0;
+
+	/** UProjectileArchetype::HashCompiledFields - 같은 스킬이라도 값이 다르면 다른 원형 */
+	uint32 CompiledHash = 0;
+};
+
+/**
+ * FSkillProjectileInfo 를 한 번만 해석해 둔 발사체 원형.
+ * 같은 스킬의 발사체들이 참조로 공유하며, 발사 시에는 템플릿 컴포넌트를 복제하고 발사별 값만 채운다.
+ */
+UCLASS(Transient)
+class UProjectileArchetype : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Compile(const FSkillProjectileInfo& InProjectileInfo, const bool bInWithVisual);
+
+	/** 원형에 남는 값(GetProjectileInfo 가 돌려주는 값 전체)의 해시. ClearPerShotFields 로 비우는 발사별 값은 제외 */
+	static uint32 HashCompiledFields(const FSkillProjectileInfo& InProjectileInfo);
+
+	/** 발사마다 달라지는 값(Caster, Target, Angle, FireDelay). 원형에는 비워둔다. */
+	static void ClearPerShotFields(FSkillProjectileInfo& InOutProjectileInfo);
+
+	/** Caster, Target 등 발사별 값은 비어있다. */
+	inline const FSkillProjectileInfo& GetProjectileInfo() const { return ProjectileInfo; }
+
+	inline const FCollisionShape& GetSweepShape() const { return SweepShape; }
+	inline const FQuat& GetSweepShapeRotation() const { return SweepShapeRotation; }
+	inline float GetMaxMoveDistance() const { return MaxMoveDistance; }
+	inline float GetTravelTime() const { return TravelTime; }
+
+	float GetLifeSpan(const float InFireDelay) const;
+
+	/** Templates (데디케이티드 서버에서는 Collision 외에는 비어있음) */
+	inline UShapeComponent* GetCollisionTemplate() const { return CollisionTemplate; }
+	inline UCustomSkeletalMeshComponent* GetMeshTemplate() const { return MeshTemplate; }
+	inline UPointLightComponent* GetLightTemplate() const { return LightTemplate; }
+	inline UCustomParticleSystemComponent* GetParticleTemplate() const { return ParticleTemplate; }
+	inline const TArray<UAudioComponent*>& GetSoundTemplates() const { return SoundTemplates; }
+
+	/** EmitterNameToDisableOnHit 를 파티클 템플릿의 이미터 인덱스로 풀어둔 값 */
+	inline const TArray<int32>& GetEmitterIndicesToDisableOnHit() const { return EmitterIndicesToDisableOnHit; }
+
+private:
+	void CompileCollision();
+	void CompileMesh();
+	void CompileLight();
+	void CompileParticle();
+	void CompileSound();
+
+private:
+	UPROPERTY()
+	FSkillProjectileInfo ProjectileInfo;
+
+	UPROPERTY()
+	UShapeComponent* CollisionTemplate = nullptr;
+
+	UPROPERTY()
+	UCustomSkeletalMeshComponent* MeshTemplate = nullptr;
+
+	UPROPERTY()
+	UPointLightComponent* LightTemplate = nullptr;
+
+	UPROPERTY()
+	UCustomParticleSystemComponent* ParticleTemplate = nullptr;
+
+	UPROPERTY()
+	TArray<UAudioComponent*> SoundTemplates;
+
+	TArray<int32> EmitterIndicesToDisableOnHit;
+
+	FCollisionShape SweepShape;
+	FQuat SweepShapeRotation = FQuat::Identity;
+
+	float MaxMoveDistance = 0.f;
+	float TravelTime = 0.f;
+};
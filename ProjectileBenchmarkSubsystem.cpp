@@ -0,0 +1,423 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileBenchmarkSubsystem.h"
+#include "BenchmarkHarness.h"
+#include "CustomProjectileActor.h"
+#include "CombatPerfCounters.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Tests/AutomationCommon.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProjectileBenchmark, Log, All);
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs GProjectileBenchmarkCommand(
+	TEXT("Projectile.Benchmark"),
+	TEXT("Fire projectiles at dummy targets and write per-frame cost as CSV. Usage: Projectile.Benchmark [Shape=Sphere|Box|Capsule] [Pierce=0|1] [Gravity=0] [FireDelay=0] [Speed=3000] [Distance=4000] [Count=100] [Waves=10] [Spread=60] [Targets=100] [TargetClass=Path] [MaxFrames=600] [Out=File.csv]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		UProjectileBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UProjectileBenchmarkSubsystem>() : nullptr;
+		if (Benchmark == nullptr)
+		{
+			return;
+		}
+
+		const FBenchmarkArgs Params(Args);
+
+		FProjectileBenchmarkConfig Config;
+
+		FString ShapeName;
+		if (Params.Value(TEXT("Shape="), ShapeName))
+		{
+			if (ShapeName == TEXT("Box"))			Config.Shape = ECollisionSweepShapeType::Box;
+			else if (ShapeName == TEXT("Capsule"))	Config.Shape = ECollisionSweepShapeType::Capsule;
+			else									Config.Shape = ECollisionSweepShapeType::Shpere;
+		}
+
+		// 캡슐은 X 가 반높이, Y 가 반지름
+		if (Config.Shape == ECollisionSweepShapeType::Capsule)
+		{
+			Config.CollisionExtent = FVector(40.f, 15.f, 15.f);
+		}
+
+		Params.Bool(TEXT("Pierce="), Config.bPierce);
+		Params.Value(TEXT("Gravity="), Config.GravityScale);
+		Params.Value(TEXT("FireDelay="), Config.FireDelay);
+		Params.Value(TEXT("Speed="), Config.Speed);
+		Params.Value(TEXT("Distance="), Config.MaxDistance);
+		Params.Value(TEXT("Count="), Config.Count);
+		Params.Value(TEXT("Waves="), Config.Waves);
+		Params.Value(TEXT("Spread="), Config.AngleSpread);
+		Params.Value(TEXT("Targets="), Config.Targets);
+		Params.Value(TEXT("TargetClass="), Config.TargetClassPath);
+		Params.Value(TEXT("MaxFrames="), Config.MaxFrames);
+		Params.Value(TEXT("Out="), Config.OutputPath);
+
+		Benchmark->Start(Config);
+	}));
+#endif
+
+void UProjectileBenchmarkSubsystem::Deinitialize()
+{
+	Stop();
+
+	Super::Deinitialize();
+}
+
+bool UProjectileBenchmarkSubsystem::Start(const FProjectileBenchmarkConfig& InConfig)
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	if (IsRunning() || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return false;
+	}
+
+	// 실제 플레이어가 접속한 서버에서는 돌리지 않는다. (독립 실행 게임의 로컬 플레이어만 허용)
+	if (GetWorld()->GetNetMode() != NM_Standalone && GetWorld()->GetNumPlayerControllers() > 0)
+	{
+		UE_LOG(LogProjectileBenchmark, Warning, TEXT("Benchmark refuses to start while players are connected."));
+		return false;
+	}
+
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (ProjectileSubsystem == nullptr || ProjectileSubsystem->SetHitPolicy(this) == false)
+	{
+		UE_LOG(LogProjectileBenchmark, Warning, TEXT("Benchmark needs a server world without an active combat capture."));
+		return false;
+	}
+
+	Config = InConfig;
+	Config.Count = FMath::Max(Config.Count, 1);
+	Config.Waves = FMath::Max(Config.Waves, 1);
+	Config.MaxFrames = FMath::Max(Config.MaxFrames, Config.Waves + 1);
+
+	Config.OutputPath = FBenchmarkCsv::ResolveOutputPath(TEXT("ProjectileBenchmark"), Config.OutputPath);
+
+	if (SpawnDummies() == false)
+	{
+		Stop();
+		return false;
+	}
+
+	bRunning = true;
+	Frame = 0;
+	FiredWaves = 0;
+	PendingSpawnMs = 0.0;
+	Samples.Reset(Config.MaxFrames);
+	LastSummary = FProjectileBenchmarkSummary();
+	LiveProjectiles.Reset(Config.Count * Config.Waves);
+	BaseUObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	// 변경 전후 수치가 같은 조건에서 나오도록
+	bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Config.FixedDeltaTime);
+
+	FMath::RandInit(0);
+
+	FCombatPerfCounters::Reset();
+	FCombatPerfCounters::bEnabled = true;
+
+	UE_LOG(LogProjectileBenchmark, Log, TEXT("Benchmark started: %d x %d projectiles, %d targets -> %s"), Config.Waves, Config.Count, Dummies.Num(), *Config.OutputPath);
+	return true;
+#endif
+}
+
+void UProjectileBenchmarkSubsystem::Stop()
+{
+	if (bRunning == true)
+	{
+		bRunning = false;
+
+		FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+		FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+		FCombatPerfCounters::bEnabled = false;
+	}
+
+	for (TWeakObjectPtr<ACustomProjectileActor>& Projectile : LiveProjectiles)
+	{
+		if (Projectile.IsValid()) Projectile->Destroy();
+	}
+
+	for (TWeakObjectPtr<ACustomCharacter>& Dummy : Dummies)
+	{
+		if (Dummy.IsValid()) Dummy->Destroy();
+	}
+
+	if (Caster.IsValid()) Caster->Destroy();
+
+	if (UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>())
+	{
+		ProjectileSubsystem->ClearHitPolicy(this);
+	}
+
+	LiveProjectiles.Empty();
+	Dummies.Empty();
+	Caster.Reset();
+}
+
+void UProjectileBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	// 이 틱 이전까지(액터 틱)의 비용을 이전 프레임의 결과로 기록
+	if (Frame > 0)
+	{
+		SampleFrame(DeltaTime);
+	}
+
+	LiveProjectiles.RemoveAllSwap([](const TWeakObjectPtr<ACustomProjectileActor>& Projectile) { return Projectile.IsValid() == false; });
+
+	if (FiredWaves < Config.Waves)
+	{
+		FireWave();
+	}
+	else if (LiveProjectiles.Num() == 0 || Frame >= Config.MaxFrames)
+	{
+		Finish();
+		return;
+	}
+
+	Frame++;
+}
+
+bool UProjectileBenchmarkSubsystem::SpawnDummies()
+{
+	UClass* TargetClass = ACustomCharacter::StaticClass();
+	if (Config.TargetClassPath.IsEmpty() == false)
+	{
+		TargetClass = LoadClass<ACustomCharacter>(nullptr, *Config.TargetClassPath);
+		if (TargetClass == nullptr)
+		{
+			UE_LOG(LogProjectileBenchmark, Warning, TEXT("Failed to load %s"), *Config.TargetClassPath);
+			return false;
+		}
+	}
+
+	auto SpawnDummy = [this, TargetClass](const FVector& InLocation, const FRotator& InRotation) -> ACustomCharacter*
+	{
+		const FTransform SpawnTM(InRotation, InLocation);
+		ACustomCharacter* NewDummy = GetWorld()->SpawnActorDeferred<ACustomCharacter>(TargetClass, SpawnTM, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (NewDummy == nullptr)
+		{
+			return nullptr;
+		}
+
+		NewDummy->AutoPossessAI = EAutoPossessAI::Disabled;
+		NewDummy->FinishSpawning(SpawnTM);
+
+		// 바닥이 없는 맵에서도 제자리에 있도록
+		if (NewDummy->GetCharacterMovement()) NewDummy->GetCharacterMovement()->DisableMovement();
+		return NewDummy;
+	};
+
+	const FVector Origin(0.f, 0.f, 1000.f);
+
+	Caster = SpawnDummy(Origin, FRotator::ZeroRotator);
+	if (Caster.IsValid() == false)
+	{
+		return false;
+	}
+
+	// 사거리의 절반부터 퍼짐 각도 안에 부채꼴로 배치
+	const int32 Columns = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)Config.Targets)), 1);
+	const float HalfSpread = FMath::Clamp(Config.AngleSpread, 10.f, 180.f) / 2.f;
+	const float MinRange = Config.MaxDistance * 0.5f;
+	const float RangeStep = Config.MaxDistance * 0.4f / Columns;
+
+	for (int Index = 0; Index < Config.Targets; Index++)
+	{
+		const int32 Row = Index / Columns;
+		const int32 Column = Index % Columns;
+
+		const float Yaw = Columns > 1 ? FMath::Lerp(-HalfSpread, HalfSpread, (float)Column / (Columns - 1)) : 0.f;
+		const FVector Location = Origin + FRotator(0.f, Yaw, 0.f).Vector() * (MinRange + RangeStep * Row);
+
+		ACustomCharacter* NewDummy = SpawnDummy(Location, FRotator(0.f, Yaw + 180.f, 0.f));
+		if (NewDummy != nullptr)
+		{
+			Dummies.Emplace(NewDummy);
+		}
+	}
+
+	return true;
+}
+
+FSkillProjectileInfo UProjectileBenchmarkSubsystem::MakeProjectileInfo() const
+{
+	static const TCHAR* ShapeNames[] = { TEXT("Sphere"), TEXT("Box"), TEXT("Capsule") };
+	const int32 ShapeIndex = Config.Shape == ECollisionSweepShapeType::Box ? 1 : (Config.Shape == ECollisionSweepShapeType::Capsule ? 2 : 0);
+
+	FSkillProjectileInfo NewInfo;
+	NewInfo.Caster = Caster.Get();
+	NewInfo.Target = nullptr;
+
+	// 원형 캐시를 타도록 설정별 CID 를 쓴다. (발사체 값이 모두 들어가야 이전 실행의 원형을 다시 쓰지 않는다.)
+	NewInfo.SkillCID = FName(*FString::Printf(TEXT("ProjectileBenchmark_%s_%s_P%d_G%g_D%g_S%g_M%g"),
+		ShapeNames[ShapeIndex], *Config.CollisionExtent.ToCompactString(), Config.bPierce ? 1 : 0,
+		Config.GravityScale, Config.FireDelay, Config.Speed, Config.MaxDistance));
+	NewInfo.AttackDamageIndex = 0;
+
+	NewInfo.CollisionShape = Config.Shape;
+	NewInfo.CollisionExtent = Config.CollisionExtent;
+	NewInfo.ProjectileSpeed = Config.Speed;
+	NewInfo.ProjectileMaxMoveDistance = Config.MaxDistance;
+	NewInfo.ProjectileGravityScale = Config.GravityScale;
+	NewInfo.FireDelay = Config.FireDelay;
+	NewInfo.bForcePierceableChar = Config.bPierce;
+	NewInfo.Angle = 0.f;
+
+	return NewInfo;
+}
+
+void UProjectileBenchmarkSubsystem::FireWave()
+{
+	UProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (ProjectileSubsystem == nullptr || Caster.IsValid() == false)
+	{
+		FiredWaves = Config.Waves;
+		return;
+	}
+
+	FProjectileVolleyPattern Pattern;
+	Pattern.Count = Config.Count;
+	Pattern.AngleSpread = Config.AngleSpread;
+
+	const FSkillProjectileInfo ProjectileInfo = MakeProjectileInfo();
+	const FTransform SpawnTM = Caster->GetActorTransform();
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<ACustomProjectileActor*> NewProjectiles = ProjectileSubsystem->FireVolley(ACustomProjectileActor::StaticClass(), SpawnTM, ProjectileInfo, Pattern);
+	PendingSpawnMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	for (ACustomProjectileActor* NewProjectile : NewProjectiles)
+	{
+		LiveProjectiles.Emplace(NewProjectile);
+	}
+
+	FiredWaves++;
+}
+
+void UProjectileBenchmarkSubsystem::SampleFrame(const float InDeltaTime)
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	FFrameSample& NewSample = Samples.AddDefaulted_GetRef();
+	NewSample.Frame = Frame;
+	NewSample.DeltaMs = InDeltaTime * 1000.f;
+	NewSample.LiveProjectiles = LiveProjectiles.Num();
+	NewSample.SpawnMs = PendingSpawnMs;
+	NewSample.SweepCalls = FCombatPerfCounters::ProjectileSweep.Calls;
+	NewSample.SweepMs = FCombatPerfCounters::ProjectileSweep.GetSeconds() * 1000.0;
+	NewSample.HitCalls = FCombatPerfCounters::HitProcessing.Calls;
+	NewSample.HitMs = FCombatPerfCounters::HitProcessing.GetSeconds() * 1000.0;
+	NewSample.UObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	NewSample.UsedPhysicalMB = MemoryStats.UsedPhysical / (1024.0 * 1024.0);
+
+	PendingSpawnMs = 0.0;
+	FCombatPerfCounters::Reset();
+}
+
+void UProjectileBenchmarkSubsystem::Finish()
+{
+	double TotalSpawnMs = 0.0;
+	double TotalSweepMs = 0.0;
+	double MaxSweepMs = 0.0;
+	double TotalHitMs = 0.0;
+	double MaxHitMs = 0.0;
+	int64 TotalSweepCalls = 0;
+	int32 PeakUObjects = 0;
+	double PeakUsedPhysicalMB = 0.0;
+
+	FBenchmarkCsv Csv(TEXT("ProjectileBenchmark"), Config.OutputPath, TEXT("Frame,DeltaMs,LiveProjectiles,SpawnMs,SweepCalls,SweepMs,HitCalls,HitMs,UObjects,UsedPhysicalMB"));
+	for (const FFrameSample& Sample : Samples)
+	{
+		Csv.AddRow(FString::Printf(TEXT("%d,%.3f,%d,%.4f,%lld,%.4f,%lld,%.4f,%d,%.1f"),
+			Sample.Frame, Sample.DeltaMs, Sample.LiveProjectiles, Sample.SpawnMs, Sample.SweepCalls, Sample.SweepMs, Sample.HitCalls, Sample.HitMs, Sample.UObjects, Sample.UsedPhysicalMB));
+
+		TotalSpawnMs += Sample.SpawnMs;
+		TotalSweepMs += Sample.SweepMs;
+		MaxSweepMs = FMath::Max(MaxSweepMs, Sample.SweepMs);
+		TotalHitMs += Sample.HitMs;
+		MaxHitMs = FMath::Max(MaxHitMs, Sample.HitMs);
+		TotalSweepCalls += Sample.SweepCalls;
+		PeakUObjects = FMath::Max(PeakUObjects, Sample.UObjects);
+		PeakUsedPhysicalMB = FMath::Max(PeakUsedPhysicalMB, Sample.UsedPhysicalMB);
+	}
+
+	const int32 NumFrames = FMath::Max(Samples.Num(), 1);
+	const int32 NumFired = Config.Count * Config.Waves;
+
+	Csv.AddSummary(FString::Printf(TEXT("Shape=%d Pierce=%d Gravity=%.2f FireDelay=%.2f Speed=%.0f Distance=%.0f Count=%d Waves=%d Targets=%d Frames=%d"),
+		(int32)Config.Shape, Config.bPierce ? 1 : 0, Config.GravityScale, Config.FireDelay, Config.Speed, Config.MaxDistance, Config.Count, Config.Waves, Dummies.Num(), Samples.Num()));
+	Csv.AddSummary(FString::Printf(TEXT("SpawnUsPerProjectile=%.3f SweepMsPerTickAvg=%.4f SweepMsPerTickMax=%.4f SweepUsPerCall=%.3f HitMsPerTickAvg=%.4f HitMsPerTickMax=%.4f PeakUObjects=%d PeakUObjectDelta=%d PeakUsedPhysicalMB=%.1f"),
+		TotalSpawnMs * 1000.0 / NumFired, TotalSweepMs / NumFrames, MaxSweepMs, TotalSweepCalls > 0 ? TotalSweepMs * 1000.0 / TotalSweepCalls : 0.0,
+		TotalHitMs / NumFrames, MaxHitMs, PeakUObjects, PeakUObjects - BaseUObjects, PeakUsedPhysicalMB));
+
+	LastSummary.Frames = Samples.Num();
+	LastSummary.SweepCalls = TotalSweepCalls;
+	LastSummary.SweepMsPerTickAvg = TotalSweepMs / NumFrames;
+	LastSummary.bSaved = Csv.Save();
+
+	Stop();
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FWaitForProjectileBenchmark, FAutomationTestBase*, Test, TWeakObjectPtr<UProjectileBenchmarkSubsystem>, Benchmark);
+
+bool FWaitForProjectileBenchmark::Update()
+{
+	if (Benchmark.IsValid() == false)
+	{
+		Test->AddError(TEXT("World went away before the benchmark finished"));
+		return true;
+	}
+
+	if (Benchmark->IsRunning())
+	{
+		return false;
+	}
+
+	const FProjectileBenchmarkSummary& Summary = Benchmark->GetLastSummary();
+	Test->TestTrue(TEXT("Benchmark wrote the CSV"), Summary.bSaved);
+	Test->TestTrue(TEXT("Benchmark sampled frames"), Summary.Frames > 0);
+	Test->TestTrue(TEXT("Projectiles swept"), Summary.SweepCalls > 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileBenchmarkTest, "Project.Benchmark.Projectile", EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::PerfFilter)
+
+bool FProjectileBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// 발사체와 더미가 틱해야 하므로 게임 월드(-game, PIE)에서만
+	UWorld* World = AutomationCommon::GetAnyGameWorld();
+	UProjectileBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UProjectileBenchmarkSubsystem>() : nullptr;
+	if (Benchmark == nullptr)
+	{
+		AddError(TEXT("Needs a game world (-game or PIE)"));
+		return false;
+	}
+
+	FProjectileBenchmarkConfig Config;
+	Config.Count = 20;
+	Config.Waves = 3;
+	Config.Targets = 16;
+	Config.MaxFrames = 120;
+	Config.OutputPath = FPaths::AutomationTransientDir() / TEXT("ProjectileBenchmark.csv");
+
+	if (Benchmark->Start(Config) == false)
+	{
+		AddError(TEXT("Benchmark failed to start"));
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForProjectileBenchmark(this, Benchmark));
+	return true;
+}
+
+#endif
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileSubsystem.h"
+#include "ProjectileBenchmarkSubsystem.generated.h"
+
+class ACustomProjectileActor;
+
+struct FProjectileBenchmarkConfig
+{
+	ECollisionSweepShapeType Shape = ECollisionSweepShapeType::Shpere;
+	FVector CollisionExtent = FVector(20.f, 20.f, 20.f);
+	bool bPierce = false;
+	float GravityScale = 0.f;
+	float FireDelay = 0.f;
+	float Speed = 3000.f;
+	float MaxDistance = 4000.f;
+
+	/** 일제 사격당 발사체 수, 일제 사격 횟수(프레임당 한 번), 퍼짐 각도 */
+	int32 Count = 100;
+	int32 Waves = 10;
+	float AngleSpread = 60.f;
+
+	int32 Targets = 100;
+	FString TargetClassPath;
+
+	/** 모든 발사체가 사라지지 않아도 이 프레임 수에서 끝낸다. */
+	int32 MaxFrames = 600;
+	float FixedDeltaTime = 1.f / 30.f;
+
+	FString OutputPath;
+};
+
+/** 마지막 측정 요약 (자동화 테스트에서 읽는다.) */
+struct FProjectileBenchmarkSummary
+{
+	int32 Frames = 0;
+	int64 SweepCalls = 0;
+	double SweepMsPerTickAvg = 0.0;
+	bool bSaved = false;
+};
+
+/**
+ * 발사체 부하 측정. 더미 대상 무리를 향해 설정한 양의 발사체를 쏘고 프레임별 비용을 CSV 로 남긴다.
+ * 고정 스텝과 고정 시드로 돌리므로 발사체 코드 변경 전후 수치를 비교할 수 있다.
+ *
+ * Projectile.Benchmark [Shape=Sphere|Box|Capsule] [Pierce=0|1] [Gravity=0] [FireDelay=0] [Speed=3000] [Distance=4000]
+ *                      [Count=100] [Waves=10] [Spread=60] [Targets=100] [TargetClass=/Game/...] [MaxFrames=600] [Out=File.csv]
+ * (-nullrhi 데디케이티드 서버 또는 -game -nullrhi 에서 실행. 접속한 플레이어가 있으면 시작하지 않으며 Shipping 빌드에서는 쓸 수 없다.)
+ * 자동화 테스트: Project.Benchmark.Projectile (게임 월드 필요)
+ */
+UCLASS()
+class UProjectileBenchmarkSubsystem : public UWorldSubsystem, public FTickableGameObject, public ICombatHitPolicy
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false && bRunning; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileBenchmarkSubsystem, STATGROUP_Tickables); }
+
+	/** ICombatHitPolicy - 측정용 시전자의 발사체만 더미를 공격할 수 있으며 데미지는 보내지 않는다. */
+	virtual bool IsSimulatedCaster(const AActor* InCaster) const override { return bRunning && InCaster != nullptr && InCaster == Caster.Get(); }
+	virtual bool CanAttack(ACustomCharacter* InCaster, AActor* InTarget) const override { return true; }
+	virtual bool CalcPierceable(ACustomCharacter* InCaster, const FSkillProjectileInfo& InProjectileInfo) const override { return InProjectileInfo.bForcePierceableChar; }
+	virtual float GetLagCompRewindMs(const ACustomCharacter* InCaster) const override { return 0.f; }
+	virtual void OnProjectileFire(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern, const bool bInPierceable) override {}
+	virtual void OnAreaInit(const UAreaComponent* InArea, const FSkillAreaInfo& InAreaInfo) override {}
+	virtual void OnHit(const ECombatHitKind InKind, AActor* InCaster, AActor* InTarget, const bool bInCanAttack) override {}
+
+	bool Start(const FProjectileBenchmarkConfig& InConfig);
+	void Stop();
+
+	inline bool IsRunning() const { return bRunning; }
+	inline const FProjectileBenchmarkSummary& GetLastSummary() const { return LastSummary; }
+
+private:
+	bool SpawnDummies();
+	void FireWave();
+	void SampleFrame(const float InDeltaTime);
+	void Finish();
+
+	FSkillProjectileInfo MakeProjectileInfo() const;
+
+private:
+	struct FFrameSample
+	{
+		int32 Frame = 0;
+		float DeltaMs = 0.f;
+		int32 LiveProjectiles = 0;
+		double SpawnMs = 0.0;
+		int64 SweepCalls = 0;
+		double SweepMs = 0.0;
+		int64 HitCalls = 0;
+		double HitMs = 0.0;
+		int32 UObjects = 0;
+		double UsedPhysicalMB = 0.0;
+	};
+
+	FProjectileBenchmarkConfig Config;
+
+	bool bRunning = false;
+	int32 Frame = 0;
+	int32 FiredWaves = 0;
+	double PendingSpawnMs = 0.0;
+
+	TWeakObjectPtr<ACustomCharacter> Caster;
+	TArray<TWeakObjectPtr<ACustomCharacter>> Dummies;
+	TArray<TWeakObjectPtr<ACustomProjectileActor>> LiveProjectiles;
+
+	TArray<FFrameSample> Samples;
+	int32 BaseUObjects = 0;
+
+	FProjectileBenchmarkSummary LastSummary;
+
+	bool bSavedUseFixedTimeStep = false;
+	double SavedFixedDeltaTime = 0.0;
+};
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileLightManager.h"
+#include "Components/PointLightComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+static TAutoConsoleVariable<int32> CVarProjectileLightMaxActive(
+	TEXT("Projectile.Light.MaxActive"),
+	8,
+	TEXT("Max number of projectile point lights visible per view."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarProjectileLightMaxShadowCasting(
+	TEXT("Projectile.Light.MaxShadowCasting"),
+	1,
+	TEXT("Max number of shadow casting projectile point lights."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarProjectileLightFadeTime(
+	TEXT("Projectile.Light.FadeTime"),
+	0.15f,
+	TEXT("Fade in/out time (seconds) of projectile point lights entering or leaving the budget."),
+	ECVF_Default);
+
+void FProjectileLightManager::Register(UPointLightComponent* InLight, const float InBaseIntensity, const bool bInWantsShadow)
+{
+	if (IsValid(InLight) == false)
+	{
+		return;
+	}
+
+	FProjectileLightEntry NewEntry;
+	NewEntry.Light = InLight;
+	NewEntry.BaseIntensity = InBaseIntensity;
+	NewEntry.bWantsShadow = bInWantsShadow;
+
+	// 예산에 선택되기 전까지는 꺼둔다.
+	InLight->SetIntensity(0.f);
+	InLight->SetCastShadows(false);
+	InLight->SetVisibility(false);
+
+	Entries.Emplace(NewEntry);
+}
+
+void FProjectileLightManager::Unregister(UPointLightComponent* InLight)
+{
+	const int Index = Entries.IndexOfByPredicate([InLight](const FProjectileLightEntry& Entry) { return Entry.Light.Get() == InLight; });
+	if (Index != INDEX_NONE)
+	{
+		Entries.RemoveAtSwap(Index);
+	}
+}
+
+void FProjectileLightManager::Reset()
+{
+	Entries.Empty();
+}
+
+void FProjectileLightManager::Tick(UWorld* InWorld, const float InDeltaTime)
+{
+	if (IsValid(InWorld) == false || Entries.Num() == 0)
+	{
+		return;
+	}
+
+	Entries.RemoveAllSwap([](const FProjectileLightEntry& Entry) { return Entry.Light.IsValid() == false; });
+
+	UpdateSignificance(InWorld);
+	UpdateSelection();
+	UpdateFade(InDeltaTime);
+}
+
+void FProjectileLightManager::UpdateSignificance(UWorld* InWorld)
+{
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	TArray<FVector, TInlineAllocator<4>> ViewDirs;
+
+	for (FConstPlayerControllerIterator Iterator = InWorld->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		if (IsValid(PlayerController) && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+			ViewDirs.Add(ViewRotation.Vector());
+		}
+	}
+
+	for (FProjectileLightEntry& Entry : Entries)
+	{
+		const UPointLightComponent* Light = Entry.Light.Get();
+		const FVector LightLocation = Light->GetComponentLocation();
+		const float Radius = FMath::Max(Light->AttenuationRadius, 1.f);
+
+		// 가장 잘 보이는 뷰 기준으로 판단
+		Entry.Significance = 0.f;
+		for (int ViewIndex = 0; ViewIndex < ViewLocations.Num(); ViewIndex++)
+		{
+			const FVector ToLight = LightLocation - ViewLocations[ViewIndex];
+			const float DistSquared = FMath::Max(ToLight.SizeSquared(), 1.f);
+
+			// 화면 뒤쪽이면서 감쇠 반경 밖인 라이트는 화면에 영향이 거의 없다.
+			const bool bInFront = FVector::DotProduct(ToLight, ViewDirs[ViewIndex]) > 0.f;
+			const float ScreenFactor = bInFront ? 1.f : (DistSquared < Radius * Radius ? 0.5f : 0.05f);
+
+			const float ViewSignificance = Entry.BaseIntensity * Radius * Radius * ScreenFactor / DistSquared;
+			Entry.Significance = FMath::Max(Entry.Significance, ViewSignificance);
+		}
+	}
+}
+
+void FProjectileLightManager::UpdateSelection()
+{
+	Entries.Sort([](const FProjectileLightEntry& A, const FProjectileLightEntry& B) { return A.Significance > B.Significance; });
+
+	const int MaxActive = FMath::Max(CVarProjectileLightMaxActive.GetValueOnGameThread(), 0);
+	const int MaxShadowCasting = FMath::Max(CVarProjectileLightMaxShadowCasting.GetValueOnGameThread(), 0);
+
+	int ShadowCastingCount = 0;
+
+	for (int Index = 0; Index < Entries.Num(); Index++)
+	{
+		FProjectileLightEntry& Entry = Entries[Index];
+		Entry.bSelected = Index < MaxActive && Entry.Significance > 0.f;
+
+		const bool bCastShadow = Entry.bSelected && Entry.bWantsShadow && ShadowCastingCount < MaxShadowCasting;
+		if (bCastShadow)
+		{
+			ShadowCastingCount++;
+		}
+
+		// 그림자는 페이드 없이 바로 끈다. (N개 제한을 넘지 않도록)
+		if (Entry.bCastingShadow != bCastShadow)
+		{
+			Entry.bCastingShadow = bCastShadow;
+			Entry.Light->SetCastShadows(bCastShadow);
+		}
+	}
+}
+
+void FProjectileLightManager::UpdateFade(const float InDeltaTime)
+{
+	const float FadeTime = CVarProjectileLightFadeTime.GetValueOnGameThread();
+	const float FadeStep = FadeTime > 0.f ? InDeltaTime / FadeTime : 1.f;
+
+	for (FProjectileLightEntry& Entry : Entries)
+	{
+		const float TargetWeight = Entry.bSelected ? 1.f : 0.f;
+		if (Entry.FadeWeight == TargetWeight)
+		{
+			continue;
+		}
+
+		Entry.FadeWeight = FMath::Clamp(Entry.FadeWeight + (Entry.bSelected ? FadeStep : -FadeStep), 0.f, 1.f);
+
+		UPointLightComponent* Light = Entry.Light.Get();
+		Light->SetIntensity(Entry.BaseIntensity * Entry.FadeWeight);
+
+		const bool bVisible = Entry.FadeWeight > 0.f;
+		if (Light->IsVisible() != bVisible)
+		{
+			Light->SetVisibility(bVisible);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class UPointLightComponent;
+
+struct FProjectileLightEntry
+{
+	TWeakObjectPtr<UPointLightComponent> Light;
+
+	float BaseIntensity = 0.f;
+	float FadeWeight = 0.f;
+	float Significance = 0.f;
+
+	bool bWantsShadow = false;
+	bool bCastingShadow = false;
+	bool bSelected = false;
+};
+
+/**
+ * 발사체 포인트 라이트 예산 관리.
+ * 뷰마다 중요도가 높은 라이트만 켜고 나머지는 페이드 아웃하며, 그림자를 드리우는 라이트 수를 제한한다.
+ */
+class FProjectileLightManager
+{
+public:
+	void Register(UPointLightComponent* InLight, const float InBaseIntensity, const bool bInWantsShadow);
+	void Unregister(UPointLightComponent* InLight);
+	void Reset();
+
+	void Tick(UWorld* InWorld, const float InDeltaTime);
+
+	inline int32 GetNumRegistered() const { return Entries.Num(); }
+
+private:
+	void UpdateSignificance(UWorld* InWorld);
+	void UpdateSelection();
+	void UpdateFade(const float InDeltaTime);
+
+private:
+	TArray<FProjectileLightEntry> Entries;
+};
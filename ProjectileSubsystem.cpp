@@ -0,0 +1,492 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileSubsystem.h"
+#include "CustomProjectileActor.h"
+#include "CombatPerfCounters.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+static TAutoConsoleVariable<float> CVarProjectileHitscanMaxTravelTime(
+	TEXT("Projectile.Hitscan.MaxTravelTime"),
+	0.066f,
+	TEXT("Projectiles that cover their max move distance within this time (seconds) are resolved as hitscan. 0: disable."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarProjectileLagCompEnable(
+	TEXT("Projectile.LagComp.Enable"),
+	1,
+	TEXT("1: rewind character hitboxes by the caster latency for projectile sweeps on the server."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarProjectileLagCompMaxRewindMs(
+	TEXT("Projectile.LagComp.MaxRewindMs"),
+	250.f,
+	TEXT("Max rewind time (ms) for projectile lag compensation."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarProjectileLagCompInterpDelayMs(
+	TEXT("Projectile.LagComp.InterpDelayMs"),
+	50.f,
+	TEXT("Client side interpolation delay (ms) added to half the caster ping when rewinding."),
+	ECVF_Default);
+
+void UProjectileSubsystem::Deinitialize()
+{
+	ArchetypeCache.Empty();
+	ScheduledProjectiles.Empty();
+	Tracers.Empty();
+	HitboxHistory.Reset();
+	LightManager.Reset();
+	SocketCache.Reset();
+	HitPolicy = nullptr;
+
+	if (TrailPool != nullptr)
+	{
+		TrailPool->Reset();
+		TrailPool = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	TickScheduledProjectiles();
+	TickTracers(DeltaTime);
+
+	if (GetWorld()->GetNetMode() != NM_Client && CVarProjectileLagCompEnable.GetValueOnGameThread() != 0)
+	{
+		HitboxHistory.Sample(GetWorld(), GetWorld()->GetTimeSeconds());
+	}
+	LightManager.Tick(GetWorld(), DeltaTime);
+
+	if (TrailPool != nullptr)
+	{
+		TrailPool->TrimIdle(GetWorld()->GetTimeSeconds());
+	}
+}
+
+UProjectileArchetype* UProjectileSubsystem::FindOrCompileArchetype(const FSkillProjectileInfo& InProjectileInfo)
+{
+	// 같은 스킬 키로 다른 값(속도, 모양, VFX 등)이 들어오면 따로 컴파일한다.
+	// 스킬에 속하지 않은 발사체(NAME_None)도 값이 같으면 같은 원형을 쓴다.
+	const FProjectileArchetypeKey InKey(InProjectileInfo.SkillCID, InProjectileInfo.AttackDamageIndex, UProjectileArchetype::HashCompiledFields(InProjectileInfo));
+
+	UProjectileArchetype*& Archetype = ArchetypeCache.FindOrAdd(InKey);
+	if (IsValid(Archetype) == false)
+	{
+		Archetype = CompileArchetype(InProjectileInfo);
+	}
+
+	return Archetype;
+}
+
+ACustomProjectileActor* UProjectileSubsystem::FireProjectile(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo)
+{
+	FProjectileVolleyPattern InPattern;
+	InPattern.Count = 1;
+
+	TArray<ACustomProjectileActor*> OutProjectiles = FireVolley(InProjectileClass, InSpawnTM, InProjectileInfo, InPattern);
+	return OutProjectiles.Num() > 0 ? OutProjectiles[0] : nullptr;
+}
+
+TArray<ACustomProjectileActor*> UProjectileSubsystem::FireVolley(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern)
+{
+	TArray<ACustomProjectileActor*> OutProjectiles;
+
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(InProjectileInfo.Caster);
+	if (IsValid(InCaster) == false || InPattern.Count <= 0)
+	{
+		return OutProjectiles;
+	}
+
+	UProjectileArchetype* InArchetype = FindOrCompileArchetype(InProjectileInfo);
+	if (IsValid(InArchetype) == false)
+	{
+		return OutProjectiles;
+	}
+
+	if (InProjectileClass == nullptr)
+	{
+		InProjectileClass = ACustomProjectileActor::StaticClass();
+	}
+
+	const bool bPierceable = IsSimulatedCaster(InCaster) ? HitPolicy->CalcPierceable(InCaster, InProjectileInfo) : ACustomProjectileActor::CalcPierceable(InCaster, InProjectileInfo);
+
+	if (HitPolicy != nullptr)
+	{
+		HitPolicy->OnProjectileFire(InProjectileClass, InSpawnTM, InProjectileInfo, InPattern, bPierceable);
+	}
+
+	TSharedPtr<FProjectileHitSet> SharedHittedActor;
+	if (InPattern.HitPolicy == EProjectileVolleyHitPolicy::OncePerVolley)
+	{
+		SharedHittedActor = MakeShared<FProjectileHitSet>();
+	}
+
+	// 각도 분배
+	float AngleStart = 0.f;
+	float AngleStep = 0.f;
+	if (InPattern.Count > 1)
+	{
+		if (InPattern.AngleSpread >= 360.f)
+		{
+			AngleStep = 360.f / InPattern.Count;
+		}
+		else
+		{
+			AngleStart = -InPattern.AngleSpread / 2.f;
+			AngleStep = InPattern.AngleSpread / (InPattern.Count - 1);
+		}
+	}
+
+	FSkillProjectileInfo ShotProjectileInfo = InProjectileInfo;
+
+	OutProjectiles.Reserve(InPattern.Count);
+	for (int Index = 0; Index < InPattern.Count; Index++)
+	{
+		ShotProjectileInfo.Angle = InProjectileInfo.Angle + AngleStart + AngleStep * Index;
+		ShotProjectileInfo.FireDelay = InProjectileInfo.FireDelay + InPattern.Stagger * Index;
+
+		ACustomProjectileActor* NewProjectile = nullptr;
+		if (FireShot(InProjectileClass, InSpawnTM, InArchetype, ShotProjectileInfo, bPierceable, SharedHittedActor, NewProjectile) && NewProjectile != nullptr)
+		{
+			OutProjectiles.Emplace(NewProjectile);
+		}
+	}
+
+	// 히트스캔으로 처리된 발사는 살아있는 발사체가 없으므로 세지 않는다.
+	if (OutProjectiles.Num() > 0)
+	{
+		InCaster->GetValidProjectileCountBySkill().FindOrAdd(InProjectileInfo.SkillCID) += OutProjectiles.Num();
+	}
+
+	return OutProjectiles;
+}
+
+bool UProjectileSubsystem::FireShot(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const bool bInPierceable, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor, ACustomProjectileActor*& OutProjectile)
+{
+	OutProjectile = nullptr;
+
+	if (CanFireAsHitscan(InArchetype, InProjectileInfo))
+	{
+		FireHitscan(InArchetype, InProjectileInfo, InSpawnTM.GetLocation(), bInPierceable, ShouldApplyHit(InProjectileClass), InSharedHittedActor);
+		return true;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = InProjectileInfo.Caster;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ACustomProjectileActor* NewProjectile = GetWorld()->SpawnActor<ACustomProjectileActor>(InProjectileClass, InSpawnTM, SpawnParams);
+	if (IsValid(NewProjectile) == false || NewProjectile->Launch(InArchetype, InProjectileInfo, bInPierceable, InSharedHittedActor) == false)
+	{
+		return false;
+	}
+
+	OutProjectile = NewProjectile;
+	return true;
+}
+
+bool UProjectileSubsystem::ShouldApplyHit(TSubclassOf<ACustomProjectileActor> InProjectileClass) const
+{
+	// 발사체 액터였다면 HasAuthority 가 참인 곳에서만 판정한다.
+	const AActor* DefaultProjectile = InProjectileClass ? InProjectileClass->GetDefaultObject<AActor>() : nullptr;
+	return GetWorld()->GetNetMode() != NM_Client || DefaultProjectile == nullptr || DefaultProjectile->GetIsReplicated() == false;
+}
+
+bool UProjectileSubsystem::CanFireAsHitscan(const UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo) const
+{
+	const float MaxTravelTime = CVarProjectileHitscanMaxTravelTime.GetValueOnGameThread();
+	if (MaxTravelTime <= 0.f || IsValid(InArchetype) == false)
+	{
+		return false;
+	}
+
+	// 직선 경로이고 바로 발사되는 경우만
+	return InProjectileInfo.FireDelay <= 0.f
+		&& InProjectileInfo.ProjectileGravityScale == 0.f
+		&& InProjectileInfo.ProjectileSpeed > 0.f
+		&& InArchetype->GetTravelTime() <= MaxTravelTime;
+}
+
+void UProjectileSubsystem::FireHitscan(UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const FVector& InStartLocation, const bool bInPierceable, const bool bInApplyHit, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor)
+{
+	ACustomCharacter* InCaster = Cast<ACustomCharacter>(InProjectileInfo.Caster);
+	if (IsValid(InCaster) == false || IsValid(InArchetype) == false)
+	{
+		return;
+	}
+
+	const FSkillProjectileInfo& ArchetypeInfo = InArchetype->GetProjectileInfo();
+	const FVector InDir = ACustomProjectileActor::CalcMoveDir(GetWorld(), InProjectileInfo, InStartLocation);
+	const FVector InVelocity = InDir * InProjectileInfo.ProjectileSpeed;
+	FVector InEndLocation = InStartLocation + InDir * InArchetype->GetMaxMoveDistance();
+
+	// 전체 경로를 한 번에 스윕
+	TArray<FHitResult> OutHits;
+	{
+		const FQuat InSweepQuat = InDir.GetSafeNormal2D().ToOrientationQuat() * InArchetype->GetSweepShapeRotation();
+
+		FCollisionQueryParams InCollParams = FCollisionQueryParams();
+		InCollParams.AddIgnoredActor(InCaster);
+		if (InSharedHittedActor.IsValid()) InCollParams.AddIgnoredActors(InSharedHittedActor->Array());
+
+		COMBAT_PERF_SCOPE(ProjectileSweep);
+		GetWorld()->SweepMultiByChannel(OutHits, InStartLocation, InEndLocation, InSweepQuat, ECollisionChannel::ECC_GameTraceChannel12, InArchetype->GetSweepShape(), InCollParams);
+	}
+
+	FProjectileHitSet LocalHittedActor;
+	FProjectileHitSet& HittedActor = InSharedHittedActor.IsValid() ? *InSharedHittedActor : LocalHittedActor;
+
+	if (bInApplyHit == true)
+	{
+		ApplyLagCompensation(InCaster, InStartLocation, InEndLocation, InArchetype->GetSweepShape(), HittedActor, OutHits);
+	}
+
+	const bool bShowHitParticle = bInApplyHit == true && bInPierceable == false && MyUtility::IsInDedicatedServer(GetWorld()) == false;
+
+	const bool bSimulated = IsSimulatedCaster(InCaster);
+	const int StopIndex = ACustomProjectileActor::ProcessSweepHits(InCaster, bSimulated, OutHits, bInPierceable, ArchetypeInfo.bForcePierceableObject,
+		[&](const FHitResult& InHitResult)
+		{
+			// 한 번의 스윕에서 같은 액터의 여러 컴포넌트가 걸릴 수 있다.
+			if (bInApplyHit == false || HittedActor.Contains(InHitResult.GetActor()))
+			{
+				return;
+			}
+
+			if (ACustomProjectileActor::SendHit(InCaster, bSimulated, ArchetypeInfo, InStartLocation, InHitResult) == true)
+			{
+				HittedActor.Emplace(InHitResult.GetActor());
+
+				if (bShowHitParticle == true)
+				{
+					ACustomProjectileActor::SpawnHitAttachParticle(GetWorld(), ArchetypeInfo.AttachParticleOnHit, Cast<ACustomCharacter>(InHitResult.GetActor()), ArchetypeInfo.TargetBoneNames, InHitResult.ImpactPoint, InVelocity);
+				}
+			}
+		});
+
+	if (OutHits.IsValidIndex(StopIndex))
+	{
+		InEndLocation = OutHits[StopIndex].Location;
+	}
+
+	if (MyUtility::IsInDedicatedServer(GetWorld()) == false)
+	{
+		SpawnTracer(InArchetype, InStartLocation, InEndLocation);
+	}
+}
+
+UProjectileTrailPool* UProjectileSubsystem::GetTrailPool()
+{
+	if (TrailPool == nullptr)
+	{
+		TrailPool = NewObject<UProjectileTrailPool>(this);
+	}
+
+	return TrailPool;
+}
+
+bool UProjectileSubsystem::SetHitPolicy(ICombatHitPolicy* InHitPolicy)
+{
+	if (HitPolicy != nullptr && HitPolicy != InHitPolicy)
+	{
+		return false;
+	}
+
+	HitPolicy = InHitPolicy;
+	return true;
+}
+
+void UProjectileSubsystem::ClearHitPolicy(const ICombatHitPolicy* InHitPolicy)
+{
+	if (HitPolicy == InHitPolicy)
+	{
+		HitPolicy = nullptr;
+	}
+}
+
+ICombatHitPolicy* UProjectileSubsystem::GetHitPolicy(const UWorld* InWorld)
+{
+	const UProjectileSubsystem* ProjectileSubsystem = InWorld ? InWorld->GetSubsystem<UProjectileSubsystem>() : nullptr;
+	return ProjectileSubsystem ? ProjectileSubsystem->GetHitPolicy() : nullptr;
+}
+
+void UProjectileSubsystem::ApplyLagCompensation(ACustomCharacter* InCaster, const FVector& InStart, const FVector& InEnd, const FCollisionShape& InShape, const FProjectileHitSet& InIgnoredActors, TArray<FHitResult>& InOutHits) const
+{
+	const float RewindMs = GetLagCompRewindMs(InCaster);
+	if (RewindMs <= 0.f)
+	{
+		return;
+	}
+
+	// 캐릭터는 현재 위치 판정 대신 기록된 위치로 판정
+	InOutHits.RemoveAll([this](const FHitResult& Hit) { return HitboxHistory.IsTracked(Hit.GetActor()); });
+
+	float SweepRadius = 0.f;
+	switch (InShape.ShapeType)
+	{
+	case ECollisionShape::Sphere:	SweepRadius = InShape.GetSphereRadius(); break;
+	case ECollisionShape::Box:		SweepRadius = InShape.GetExtent().Size(); break;
+	case ECollisionShape::Capsule:	SweepRadius = InShape.GetCapsuleHalfHeight(); break;
+	default: break;
+	}
+
+	const double RewindTime = GetWorld()->GetTimeSeconds() - RewindMs * 0.001f;
+	HitboxHistory.SweepAtTime(RewindTime, InStart, InEnd, SweepRadius,
+		[InCaster, &InIgnoredActors](const AActor* InActor) { return InActor == InCaster || InIgnoredActors.Contains(InActor); },
+		InOutHits);
+
+	InOutHits.Sort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+}
+
+float UProjectileSubsystem::GetLagCompRewindMs(const ACustomCharacter* InCaster) const
+{
+	if (CVarProjectileLagCompEnable.GetValueOnGameThread() == 0 || GetWorld()->GetNetMode() == NM_Client || IsValid(InCaster) == false)
+	{
+		return 0.f;
+	}
+
+	// 대역은 PlayerState 가 없으므로 정책이 정한다.
+	if (IsSimulatedCaster(InCaster))
+	{
+		return HitPolicy->GetLagCompRewindMs(InCaster);
+	}
+
+	// 원격 플레이어가 쏜 경우만 되감는다.
+	const APlayerState* InCasterState = InCaster->GetPlayerState();
+	if (IsValid(InCasterState) == false || InCaster->IsLocallyControlled() || InCasterState->IsABot())
+	{
+		return 0.f;
+	}
+
+	return FMath::Max(FMath::Min(InCasterState->ExactPing * 0.5f + CVarProjectileLagCompInterpDelayMs.GetValueOnGameThread(), CVarProjectileLagCompMaxRewindMs.GetValueOnGameThread()), 0.f);
+}
+
+void UProjectileSubsystem::SpawnTracer(const UProjectileArchetype* InArchetype, const FVector& InStartLocation, const FVector& InEndLocation)
+{
+	const FSkillProjectileInfo& ArchetypeInfo = InArchetype->GetProjectileInfo();
+	if (ArchetypeInfo.ProjectileParticle == nullptr || ArchetypeInfo.ProjectileSpeed <= 0.f)
+	{
+		return;
+	}
+
+	const FVector InDir = (InEndLocation - InStartLocation).GetSafeNormal();
+	UParticleSystemComponent* Particle = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ArchetypeInfo.ProjectileParticle, InStartLocation, InDir.Rotation(), FVector::OneVector, false, EPSCPoolMethod::AutoRelease);
+	if (Particle == nullptr)
+	{
+		return;
+	}
+
+	FProjectileTracer NewTracer;
+	NewTracer.Particle = Particle;
+	NewTracer.StartLocation = InStartLocation;
+	NewTracer.EndLocation = InEndLocation;
+	NewTracer.Duration = FVector::Dist(InStartLocation, InEndLocation) / ArchetypeInfo.ProjectileSpeed;
+
+	Tracers.Emplace(NewTracer);
+}
+
+void UProjectileSubsystem::TickTracers(const float InDeltaTime)
+{
+	for (int Index = 0; Index < Tracers.Num(); Index++)
+	{
+		FProjectileTracer& Tracer = Tracers[Index];
+		Tracer.ElapsedTime += InDeltaTime;
+
+		UParticleSystemComponent* Particle = Tracer.Particle.Get();
+		if (Particle == nullptr)
+		{
+			Tracers.RemoveAtSwap(Index--);
+			continue;
+		}
+
+		const float Alpha = Tracer.Duration > 0.f ? FMath::Min(Tracer.ElapsedTime / Tracer.Duration, 1.f) : 1.f;
+		Particle->SetWorldLocation(FMath::Lerp(Tracer.StartLocation, Tracer.EndLocation, Alpha));
+
+		if (Alpha >= 1.f)
+		{
+			// AutoRelease 이므로 재생이 끝나면 풀로 돌아간다.
+			Particle->Deactivate();
+			Tracers.RemoveAtSwap(Index--);
+		}
+	}
+}
+
+void UProjectileSubsystem::ScheduleProjectile(ACustomProjectileActor* InProjectile, const FName InSkillCID, const float InFireDelay)
+{
+	if (IsValid(InProjectile) == false)
+	{
+		return;
+	}
+
+	FScheduledProjectile NewSchedule;
+	NewSchedule.Projectile = InProjectile;
+	NewSchedule.Caster = InProjectile->GetOwner();
+	NewSchedule.SkillCID = InSkillCID;
+	NewSchedule.FireTime = GetWorld()->GetTimeSeconds() + InFireDelay;
+
+	ScheduledProjectiles.HeapPush(NewSchedule);
+}
+
+void UProjectileSubsystem::CancelScheduledProjectiles(const AActor* InCaster, const FName InSkillCID)
+{
+	if (InCaster == nullptr || ScheduledProjectiles.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<ACustomProjectileActor*> CanceledProjectiles;
+
+	const int NumRemoved = ScheduledProjectiles.RemoveAllSwap([&](const FScheduledProjectile& Schedule)
+	{
+		if (Schedule.Caster.Get() != InCaster || (InSkillCID != NAME_None && Schedule.SkillCID != InSkillCID))
+		{
+			return false;
+		}
+
+		if (Schedule.Projectile.IsValid())
+		{
+			CanceledProjectiles.Emplace(Schedule.Projectile.Get());
+		}
+		return true;
+	});
+
+	if (NumRemoved > 0)
+	{
+		ScheduledProjectiles.Heapify();
+	}
+
+	for (ACustomProjectileActor* Projectile : CanceledProjectiles)
+	{
+		Projectile->OnScheduledCancel();
+	}
+}
+
+void UProjectileSubsystem::TickScheduledProjectiles()
+{
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	while (ScheduledProjectiles.Num() > 0 && ScheduledProjectiles.HeapTop().FireTime <= CurrentTime)
+	{
+		TWeakObjectPtr<ACustomProjectileActor> Projectile = ScheduledProjectiles.HeapTop().Projectile;
+		ScheduledProjectiles.HeapPopDiscard();
+
+		if (Projectile.IsValid())
+		{
+			Projectile->OnScheduledFire();
+		}
+	}
+}
+
+UProjectileArchetype* UProjectileSubsystem::CompileArchetype(const FSkillProjectileInfo& InProjectileInfo)
+{
+	UProjectileArchetype* OutArchetype = NewObject<UProjectileArchetype>(this);
+	if (OutArchetype)
+	{
+		OutArchetype->Compile(InProjectileInfo, MyUtility::IsInDedicatedServer(GetWorld()) == false);
+	}
+
+	return OutArchetype;
+}
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileArchetype.h"
+#include "ProjectileLightManager.h"
+#include "SkeletalSocketCache.h"
+#include "HitboxHistory.h"
+#include "ProjectileTrailPool.h"
+#include "CombatHitPolicy.h"
+#include "ProjectileSubsystem.generated.h"
+
+class ACustomProjectileActor;
+class UParticleSystemComponent;
+
+using FProjectileHitSet = TSet<TWeakObjectPtr<const AActor>>;
+
+UENUM()
+enum class EProjectileVolleyHitPolicy : uint8
+{
+	PerProjectile,	// 발사체마다 따로 맞는다.
+	OncePerVolley,	// 같은 일제 사격 안에서는 대상당 한 번만 맞는다.
+};
+
+USTRUCT(BlueprintType)
+struct FProjectileVolleyPattern
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Count = 1;
+
+	/** 전체 퍼짐 각도. 360 이상이면 원형으로 균등 배치 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AngleSpread = 0.f;
+
+	/** 발사체 간 추가 FireDelay */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Stagger = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EProjectileVolleyHitPolicy HitPolicy = EProjectileVolleyHitPolicy::PerProjectile;
+};
+
+UCLASS()
+class UProjectileSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables); }
+
+	/** Archetype */
+	UProjectileArchetype* FindOrCompileArchetype(const FSkillProjectileInfo& InProjectileInfo);
+
+	/** 단발 발사. 한두 프레임 안에 최대 거리를 지나는 발사체는 액터 없이 히트스캔으로 처리하고 nullptr 를 반환한다. */
+	ACustomProjectileActor* FireProjectile(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo);
+
+	/** Hitscan */
+	bool CanFireAsHitscan(const UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo) const;
+	void FireHitscan(UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const FVector& InStartLocation, const bool bInPierceable, const bool bInApplyHit, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor);
+
+	/** Volley - 시전자 검사, 관통 판정, 원형 준비, 발사체 수 갱신을 한 번만 한다. */
+	TArray<ACustomProjectileActor*> FireVolley(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, const FSkillProjectileInfo& InProjectileInfo, const FProjectileVolleyPattern& InPattern);
+
+	/** Delayed fire - FireDelay 동안 틱 없이 대기하다가 발사 시점에 깨운다. */
+	void ScheduleProjectile(ACustomProjectileActor* InProjectile, const FName InSkillCID, const float InFireDelay);
+
+	/** 스킬이 캔슬되었을 때 시전자가 호출. InSkillCID 가 NAME_None 이면 시전자의 예약 발사체를 모두 취소한다. */
+	void CancelScheduledProjectiles(const AActor* InCaster, const FName InSkillCID);
+
+	/** Lag compensation - 시전자의 지연만큼 되감은 캐릭터 위치로 캐릭터 판정을 대신한다. (서버 전용) */
+	void ApplyLagCompensation(ACustomCharacter* InCaster, const FVector& InStart, const FVector& InEnd, const FCollisionShape& InShape, const FProjectileHitSet& InIgnoredActors, TArray<FHitResult>& InOutHits) const;
+
+	/** 되감을 시간 (ms). 되감지 않는 시전자(로컬, 봇, 클라이언트)는 0 */
+	float GetLagCompRewindMs(const ACustomCharacter* InCaster) const;
+
+	/** Light */
+	inline FProjectileLightManager& GetLightManager() { return LightManager; }
+
+	/** Socket */
+	inline FSkeletalSocketCache& GetSocketCache() { return SocketCache; }
+
+	/** Trail */
+	UProjectileTrailPool* GetTrailPool();
+
+	/** Hit policy - 녹화/재생, 측정 코드가 등록한다. 한 번에 하나만 등록할 수 있다. */
+	bool SetHitPolicy(ICombatHitPolicy* InHitPolicy);
+	void ClearHitPolicy(const ICombatHitPolicy* InHitPolicy);
+	inline ICombatHitPolicy* GetHitPolicy() const { return HitPolicy; }
+	static ICombatHitPolicy* GetHitPolicy(const UWorld* InWorld);
+
+	/** 등록된 정책이 만든 대역인지 */
+	inline bool IsSimulatedCaster(const AActor* InCaster) const { return HitPolicy != nullptr && HitPolicy->IsSimulatedCaster(InCaster); }
+
+private:
+	UProjectileArchetype* CompileArchetype(const FSkillProjectileInfo& InProjectileInfo);
+
+	void TickScheduledProjectiles();
+
+	/** 액터를 스폰하거나 히트스캔으로 처리. 발사 실패시 false */
+	bool FireShot(TSubclassOf<ACustomProjectileActor> InProjectileClass, const FTransform& InSpawnTM, UProjectileArchetype* InArchetype, const FSkillProjectileInfo& InProjectileInfo, const bool bInPierceable, const TSharedPtr<FProjectileHitSet>& InSharedHittedActor, ACustomProjectileActor*& OutProjectile);
+
+	bool ShouldApplyHit(TSubclassOf<ACustomProjectileActor> InProjectileClass) const;
+
+	void SpawnTracer(const UProjectileArchetype* InArchetype, const FVector& InStartLocation, const FVector& InEndLocation);
+	void TickTracers(const float InDeltaTime);
+
+private:
+	UPROPERTY()
+	TMap<FProjectileArchetypeKey, UProjectileArchetype*> ArchetypeCache;
+
+	UPROPERTY()
+	UProjectileTrailPool* TrailPool = nullptr;
+
+	struct FScheduledProjectile
+	{
+		TWeakObjectPtr<ACustomProjectileActor> Projectile;
+		TWeakObjectPtr<const AActor> Caster;
+		FName SkillCID = NAME_None;
+		double FireTime = 0.0;
+
+		inline bool operator<(const FScheduledProjectile& Other) const { return FireTime < Other.FireTime; }
+	};
+
+	/** FireTime 기준 힙 */
+	TArray<FScheduledProjectile> ScheduledProjectiles;
+
+	/** 히트스캔 발사체의 클라이언트 표시용 트레이서 */
+	struct FProjectileTracer
+	{
+		TWeakObjectPtr<UParticleSystemComponent> Particle;
+		FVector StartLocation = FVector::ZeroVector;
+		FVector EndLocation = FVector::ZeroVector;
+		float Duration = 0.f;
+		float ElapsedTime = 0.f;
+	};
+
+	TArray<FProjectileTracer> Tracers;
+
+	FProjectileLightManager LightManager;
+
+	FSkeletalSocketCache SocketCache;
+
+	FHitboxHistory HitboxHistory;
+
+	/** 등록한 쪽(녹화/재생, 측정)이 해제할 때까지 유효 */
+	ICombatHitPolicy* HitPolicy = nullptr;
+};
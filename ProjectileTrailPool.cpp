@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileTrailPool.h"
+#include "CustomParticleSystemComponent.h"
+#include "Particles/ParticleEmitterInstances.h"
+#include "Particles/ParticleSystem.h"
+
+static TAutoConsoleVariable<int32> CVarProjectileTrailPoolMaxFreePerTemplate(
+	TEXT("Projectile.TrailPool.MaxFreePerTemplate"),
+	32,
+	TEXT("Max idle trail components kept per particle system. Extra trails are destroyed when they finish."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarProjectileTrailPoolIdleTimeout(
+	TEXT("Projectile.TrailPool.IdleTimeout"),
+	30.f,
+	TEXT("Idle trails of a particle system that has not been acquired for this many seconds are destroyed. 0: keep until the world ends."),
+	ECVF_Default);
+
+UCustomParticleSystemComponent* UProjectileTrailPool::Acquire(UWorld* InWorld, UCustomParticleSystemComponent* InTemplate, const TArray<int32>& InEmitterIndicesToDisable)
+{
+	UParticleSystem* InParticle = InTemplate ? InTemplate->Template : nullptr;
+	if (IsValid(InWorld) == false || InParticle == nullptr)
+	{
+		return nullptr;
+	}
+
+	UCustomParticleSystemComponent* OutTrail = nullptr;
+
+	FProjectileTrailList& FreeList = FreeTrails.FindOrAdd(InParticle);
+	FreeList.LastAcquireTime = InWorld->GetTimeSeconds();
+	while (FreeList.Trails.Num() > 0 && OutTrail == nullptr)
+	{
+		UCustomParticleSystemComponent* FreeTrail = FreeList.Trails.Pop(false);
+		NumFree--;
+
+		if (IsValid(FreeTrail) == true && FreeTrail->GetWorld() == InWorld)
+		{
+			OutTrail = FreeTrail;
+		}
+	}
+
+	if (OutTrail != nullptr)
+	{
+		// 분리될 때 월드 트랜스폼으로 바뀐 값을 템플릿 값으로 되돌린다.
+		OutTrail->SetRelativeTransform(InTemplate->GetRelativeTransform());
+
+		// 이전 발사체의 중요도 처리(숨김, LOD 고정) 초기화
+		OutTrail->SetVisibility(true);
+		OutTrail->bOverrideLODMethod = false;
+
+		for (const int32 EmitterIndex : InEmitterIndicesToDisable)
+		{
+			if (OutTrail->EmitterInstances.IsValidIndex(EmitterIndex) && OutTrail->EmitterInstances[EmitterIndex] != nullptr)
+			{
+				OutTrail->EmitterInstances[EmitterIndex]->bEnabled = true;
+			}
+		}
+	}
+	else
+	{
+		//Projectile이 Destroy되도 Trail은 남아야하기 때문에 월드를 오너로 세팅
+		OutTrail = NewObject<UCustomParticleSystemComponent>(InWorld, NAME_None, RF_NoFlags, InTemplate);
+		if (OutTrail == nullptr)
+		{
+			return nullptr;
+		}
+
+		OutTrail->bAutoDestroy = false;
+		OutTrail->OnSystemFinished.AddUniqueDynamic(this, &UProjectileTrailPool::OnTrailFinished);
+		OutTrail->RegisterComponentWithWorld(InWorld);
+	}
+
+	ActiveTrails.Add(OutTrail, InParticle);
+	return OutTrail;
+}
+
+void UProjectileTrailPool::ReleaseDeferred(UCustomParticleSystemComponent* InTrail, const TArray<int32>& InEmitterIndicesToDisable)
+{
+	if (IsValid(InTrail) == false || ActiveTrails.Contains(InTrail) == false)
+	{
+		return;
+	}
+
+	for (const int32 EmitterIndex : InEmitterIndicesToDisable)
+	{
+		if (InTrail->EmitterInstances.IsValidIndex(EmitterIndex) && InTrail->EmitterInstances[EmitterIndex] != nullptr)
+		{
+			InTrail->EmitterInstances[EmitterIndex]->bEnabled = false;
+		}
+	}
+
+	InTrail->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+
+	if (InTrail->IsActive() == true)
+	{
+		// 남은 파티클이 모두 사라지면 OnTrailFinished 로 돌아온다.
+		ReleasedTrails.Add(InTrail);
+		InTrail->Deactivate();
+	}
+	else
+	{
+		ReturnToFreeList(InTrail);
+	}
+}
+
+void UProjectileTrailPool::ReleaseImmediate(UCustomParticleSystemComponent* InTrail)
+{
+	if (IsValid(InTrail) == false || ActiveTrails.Contains(InTrail) == false)
+	{
+		return;
+	}
+
+	InTrail->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+
+	if (InTrail->IsActive() == true)
+	{
+		InTrail->DeactivateImmediate();
+	}
+
+	ReturnToFreeList(InTrail);
+}
+
+void UProjectileTrailPool::Reset()
+{
+	for (TPair<UParticleSystem*, FProjectileTrailList>& FreeList : FreeTrails)
+	{
+		for (UCustomParticleSystemComponent* FreeTrail : FreeList.Value.Trails)
+		{
+			if (IsValid(FreeTrail)) FreeTrail->DestroyComponent();
+		}
+	}
+
+	for (TPair<UCustomParticleSystemComponent*, UParticleSystem*>& ActiveTrail : ActiveTrails)
+	{
+		if (IsValid(ActiveTrail.Key)) ActiveTrail.Key->DestroyComponent();
+	}
+
+	FreeTrails.Empty();
+	ActiveTrails.Empty();
+	ReleasedTrails.Empty();
+	NumFree = 0;
+	NextTrimTime = 0.0;
+}
+
+void UProjectileTrailPool::TrimIdle(const double InNow)
+{
+	const float IdleTimeout = CVarProjectileTrailPoolIdleTimeout.GetValueOnGameThread();
+	if (IdleTimeout <= 0.f || InNow < NextTrimTime)
+	{
+		return;
+	}
+
+	NextTrimTime = InNow + FMath::Min(IdleTimeout, 1.f);
+
+	for (auto It = FreeTrails.CreateIterator(); It; ++It)
+	{
+		if (InNow - It.Value().LastAcquireTime < IdleTimeout)
+		{
+			continue;
+		}
+
+		for (UCustomParticleSystemComponent* FreeTrail : It.Value().Trails)
+		{
+			if (IsValid(FreeTrail)) FreeTrail->DestroyComponent();
+		}
+
+		// 사용 중인 트레일은 돌아올 때 목록을 다시 만든다.
+		NumFree -= It.Value().Trails.Num();
+		It.RemoveCurrent();
+	}
+}
+
+void UProjectileTrailPool::OnTrailFinished(UParticleSystemComponent* InTrail)
+{
+	// 발사체에 붙어 있는 동안 끝난 경우(루프가 아닌 파티클)는 발사체가 넘겨줄 때까지 기다린다.
+	UCustomParticleSystemComponent* InFinishedTrail = Cast<UCustomParticleSystemComponent>(InTrail);
+	if (InFinishedTrail != nullptr && ReleasedTrails.Contains(InFinishedTrail) == true)
+	{
+		ReturnToFreeList(InFinishedTrail);
+	}
+}
+
+void UProjectileTrailPool::ReturnToFreeList(UCustomParticleSystemComponent* InTrail)
+{
+	UParticleSystem* InParticle = nullptr;
+	if (InTrail == nullptr || ActiveTrails.RemoveAndCopyValue(InTrail, InParticle) == false)
+	{
+		return;
+	}
+
+	ReleasedTrails.Remove(InTrail);
+
+	FProjectileTrailList& FreeList = FreeTrails.FindOrAdd(InParticle);
+	if (FreeList.Trails.Num() >= CVarProjectileTrailPoolMaxFreePerTemplate.GetValueOnGameThread())
+	{
+		InTrail->DestroyComponent();
+		return;
+	}
+
+	FreeList.Trails.Add(InTrail);
+	NumFree++;
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ProjectileTrailPool.generated.h"
+
+class UWorld;
+class UParticleSystem;
+class UParticleSystemComponent;
+class UCustomParticleSystemComponent;
+
+USTRUCT()
+struct FProjectileTrailList
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<UCustomParticleSystemComponent*> Trails;
+
+	/** 이 파티클로 마지막으로 Acquire 한 시각 (TrimIdle) */
+	double LastAcquireTime = 0.0;
+};
+
+/**
+ * 발사체 트레일 파티클 풀.
+ * 발사체가 사라진 뒤에도 남는 트레일을 넘겨받아 재생이 끝나면 같은 파티클 에셋의 다음 발사체에 재사용한다.
+ * 원형마다 템플릿이 따로 있어도 에셋이 같으면 같은 목록을 쓰고, 상대 트랜스폼은 Acquire 에서 템플릿 값으로 맞춘다.
+ */
+UCLASS(Transient)
+class UProjectileTrailPool : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 템플릿(UProjectileArchetype 의 파티클 템플릿)과 같은 설정의 비활성 트레일. 월드에 등록된 상태로 반환
+	 * InEmitterIndicesToDisable 은 이전 사용에서 꺼두었을 수 있는 이미터 (템플릿마다 고정)
+	 */
+	UCustomParticleSystemComponent* Acquire(UWorld* InWorld, UCustomParticleSystemComponent* InTemplate, const TArray<int32>& InEmitterIndicesToDisable);
+
+	/** 분리해서 남은 파티클이 사라질 때까지 재생한 뒤 풀로 돌린다. */
+	void ReleaseDeferred(UCustomParticleSystemComponent* InTrail, const TArray<int32>& InEmitterIndicesToDisable);
+
+	/** 즉시 정지하고 풀로 돌린다. */
+	void ReleaseImmediate(UCustomParticleSystemComponent* InTrail);
+
+	void Reset();
+
+	/** 한동안 Acquire 되지 않은 파티클의 대기 트레일을 정리한다. */
+	void TrimIdle(const double InNow);
+
+	inline int32 GetNumActive() const { return ActiveTrails.Num(); }
+	inline int32 GetNumFree() const { return NumFree; }
+
+private:
+	UFUNCTION()
+	void OnTrailFinished(UParticleSystemComponent* InTrail);
+
+	void ReturnToFreeList(UCustomParticleSystemComponent* InTrail);
+
+private:
+	/** 파티클 에셋별 대기 중인 트레일 */
+	UPROPERTY()
+	TMap<UParticleSystem*, FProjectileTrailList> FreeTrails;
+
+	/** 사용 중인(발사체에 붙어있거나 남은 파티클을 재생 중인) 트레일 -> 파티클 에셋 */
+	UPROPERTY()
+	TMap<UCustomParticleSystemComponent*, UParticleSystem*> ActiveTrails;
+
+	/** 발사체에서 넘겨받아 남은 파티클을 재생 중인 트레일 (ActiveTrails 의 부분집합) */
+	TSet<UCustomParticleSystemComponent*> ReleasedTrails;
+
+	int32 NumFree = 0;
+
+	double NextTrimTime = 0.0;
+};
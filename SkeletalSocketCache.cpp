@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalSocketCache.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+const TArray<FResolvedSocket>& FSkeletalSocketCache::Resolve(const USkeletalMesh* InMesh, const TArray<FName>& InSocketNames)
+{
+	static const TArray<FResolvedSocket> EmptySockets;
+	if (IsValid(InMesh) == false)
+	{
+		return EmptySockets;
+	}
+
+	const uint32 NamesHash = HashSocketNames(InSocketNames);
+
+	TMultiMap<uint32, FResolvedSocketList>& SocketLists = MeshSocketLists.FindOrAdd(FObjectKey(InMesh));
+
+	TArray<FResolvedSocketList*, TInlineAllocator<2>> Candidates;
+	SocketLists.MultiFindPointer(NamesHash, Candidates);
+	for (FResolvedSocketList* Candidate : Candidates)
+	{
+		if (Candidate->SocketNames == InSocketNames)
+		{
+			return Candidate->Sockets;
+		}
+	}
+
+	FResolvedSocketList& NewList = SocketLists.Add(NamesHash);
+	NewList.SocketNames = InSocketNames;
+	NewList.Sockets.Reserve(InSocketNames.Num());
+
+	const FReferenceSkeleton& RefSkeleton = InMesh->GetRefSkeleton();
+	for (const FName& SocketName : InSocketNames)
+	{
+		FResolvedSocket& Resolved = NewList.Sockets.AddDefaulted_GetRef();
+		Resolved.SocketName = SocketName;
+
+		const USkeletalMeshSocket* Socket = InMesh->FindSocket(SocketName);
+		if (Socket != nullptr)
+		{
+			Resolved.BoneIndex = RefSkeleton.FindBoneIndex(Socket->BoneName);
+			Resolved.LocalTransform = Socket->GetSocketLocalTransform();
+		}
+		else
+		{
+			Resolved.BoneIndex = RefSkeleton.FindBoneIndex(SocketName);
+		}
+	}
+
+	return NewList.Sockets;
+}
+
+FTransform FSkeletalSocketCache::GetSocketTransform(const USkeletalMeshComponent* InComponent, const FResolvedSocket& InSocket) const
+{
+	// 마스터 포즈를 따르는 컴포넌트는 본 인덱스가 다를 수 있으므로 엔진 조회로 처리
+	if (InComponent->MasterPoseComponent.IsValid())
+	{
+		return InComponent->GetSocketTransform(InSocket.SocketName);
+	}
+
+	const TArray<FTransform>& ComponentSpaceTransforms = InComponent->GetComponentSpaceTransforms();
+	if (ComponentSpaceTransforms.IsValidIndex(InSocket.BoneIndex) == false)
+	{
+		return InComponent->GetComponentTransform();
+	}
+
+	return InSocket.LocalTransform * ComponentSpaceTransforms[InSocket.BoneIndex] * InComponent->GetComponentTransform();
+}
+
+bool FSkeletalSocketCache::FindClosestSocket(const USkeletalMeshComponent* InComponent, const TArray<FName>& InSocketNames, const FVector& InPoint, FName& OutSocketName, FTransform& OutSocketTM)
+{
+	if (IsValid(InComponent) == false)
+	{
+		return false;
+	}
+
+	OutSocketName = NAME_None;
+	float MinDistSquared = 0.f;
+
+	for (const FResolvedSocket& Socket : Resolve(InComponent->SkeletalMesh, InSocketNames))
+	{
+		const FTransform SocketTM = GetSocketTransform(InComponent, Socket);
+		const float DistSquared = FVector::DistSquared(SocketTM.GetLocation(), InPoint);
+		if (OutSocketName == NAME_None || DistSquared < MinDistSquared)
+		{
+			OutSocketName = Socket.SocketName;
+			OutSocketTM = SocketTM;
+			MinDistSquared = DistSquared;
+		}
+	}
+
+	return OutSocketName != NAME_None;
+}
+
+void FSkeletalSocketCache::Reset()
+{
+	MeshSocketLists.Empty();
+}
+
+uint32 FSkeletalSocketCache::HashSocketNames(const TArray<FName>& InSocketNames)
+{
+	uint32 OutHash = GetTypeHash(InSocketNames.Num());
+	for (const FName& SocketName : InSocketNames)
+	{
+		OutHash = HashCombine(OutHash, GetTypeHash(SocketName));
+	}
+
+	return OutHash;
+}
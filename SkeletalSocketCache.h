@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+struct FResolvedSocket
+{
+	FName SocketName = NAME_None;
+
+	/** INDEX_NONE 이면 찾지 못한 이름. (GetSocketTransform 과 같이 컴포넌트 트랜스폼으로 처리) */
+	int32 BoneIndex = INDEX_NONE;
+
+	/** 본 기준 소켓 트랜스폼. 본 이름이면 Identity */
+	FTransform LocalTransform = FTransform::Identity;
+};
+
+/**
+ * 스켈레탈 메시별로 소켓/본 이름 목록을 본 인덱스로 한 번만 풀어두는 캐시.
+ * 조회는 이미 계산된 컴포넌트 스페이스 트랜스폼에서 바로 한다.
+ */
+class FSkeletalSocketCache
+{
+public:
+	/** 결과는 InSocketNames 와 같은 순서, 같은 개수 */
+	const TArray<FResolvedSocket>& Resolve(const USkeletalMesh* InMesh, const TArray<FName>& InSocketNames);
+
+	FTransform GetSocketTransform(const USkeletalMeshComponent* InComponent, const FResolvedSocket& InSocket) const;
+
+	/** InPoint 에서 가장 가까운 소켓을 한 번의 순회로 찾는다. */
+	bool FindClosestSocket(const USkeletalMeshComponent* InComponent, const TArray<FName>& InSocketNames, const FVector& InPoint, FName& OutSocketName, FTransform& OutSocketTM);
+
+	void Reset();
+
+private:
+	struct FResolvedSocketList
+	{
+		TArray<FName> SocketNames;
+		TArray<FResolvedSocket> Sockets;
+	};
+
+	static uint32 HashSocketNames(const TArray<FName>& InSocketNames);
+
+private:
+	TMap<FObjectKey, TMultiMap<uint32, FResolvedSocketList>> MeshSocketLists;
+};
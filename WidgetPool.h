@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/PanelWidget.h"
+#include "WidgetPoolSubsystem.h"
+#include "WidgetPoolStats.h"
+#include "WidgetPool.generated.h"
+
+/**
+ * TWidgetPool 의 상태. 가진 UObject 가 UPROPERTY 로 들고 있어야 GC 가 위젯을 참조로 본다.
+ * 템플릿은 USTRUCT 가 될 수 없으므로 목록은 UUserWidget* 로 두고, TWidgetPool 이 T* 로 보여준다.
+ */
+USTRUCT()
+struct FWidgetPoolLists
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	UPanelWidget* Panel = nullptr;
+
+	UPROPERTY()
+	UClass* ChildClass = nullptr;
+
+	UPROPERTY()
+	TArray<UUserWidget*> ActivatedChildList;
+
+	UPROPERTY()
+	TArray<UUserWidget*> DeActivatedChildList;
+
+	TSharedPtr<FWidgetPoolStats> Stats;
+};
+
+/**
+ * FWidgetPoolContainer 의 타입 지정 버전. 매 프레임 갱신하는 목록(이름표, 대미지 숫자 등)용.
+ * 목록의 위젯은 모두 T 이므로 Cast 가 없고, 초기화 콜백은 TFunction 없이 생성된 위젯들의 TArrayView 로 바로 호출한다.
+ * 상태는 가진 쪽의 UPROPERTY FWidgetPoolLists 에 두고 이 클래스는 그것을 가리키기만 한다.
+ *
+ *	UPROPERTY(Transient)
+ *	FWidgetPoolLists PoolLists;
+ *
+ *	TWidgetPool<UMyEntry> Pool{ PoolLists };
+ *
+ * 핸들, 가상 리스트, SyncToData 등은 FWidgetPoolContainer 에만 있다.
+ */
+template<typename T>
+class TWidgetPool
+{
+	static_assert(TIsDerivedFrom<T, UUserWidget>::IsDerived, "TWidgetPool only supports UUserWidget types.");
+
+public:
+	explicit TWidgetPool(FWidgetPoolLists& InLists) : Lists(&InLists) {}
+
+	/** Init - 통계의 클래스, 패널도 여기서 한 번만 정한다. */
+	void Init(UPanelWidget* InPanel, TSubclassOf<T> InChildClass)
+	{
+		Lists->Panel = InPanel;
+		Lists->ChildClass = InChildClass;
+		Lists->Panel->ClearChildren();
+
+		FWidgetPoolStats& InStats = GetStats();
+		InStats.ClassName = Lists->ChildClass ? Lists->ChildClass->GetFName() : NAME_None;
+		InStats.Panel = Lists->Panel;
+	}
+
+	/** Create child */
+	T* GetChild()
+	{
+		// 대기 중에 파괴된 위젯은 버린다.
+		while (Lists->DeActivatedChildList.Num() > 0)
+		{
+			UUserWidget* OutChild = Lists->DeActivatedChildList.Pop(false);
+			if (IsValid(OutChild))
+			{
+				GetStats().Reacquires++;
+				INC_DWORD_STAT(STAT_WidgetPoolReacquire);
+				return static_cast<T*>(OutChild);
+			}
+		}
+
+		if (UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Lists->Panel))
+		{
+			// 공유 풀은 클래스가 정확히 같은 위젯만 돌려준다.
+			if (UUserWidget* OutChild = SharedPool->Acquire(Lists->ChildClass))
+			{
+				GetStats().SharedHits++;
+				INC_DWORD_STAT(STAT_WidgetPoolSharedHit);
+				return static_cast<T*>(OutChild);
+			}
+		}
+
+		return CreateNewChild();
+	}
+
+	/** Create child & Add to panel */
+	T* AddToPanel()
+	{
+		T* OutChild = AddToPanelNoCount();
+		UpdateCounts();
+		return OutChild;
+	}
+
+	/** InInitFunc(TArrayView<T* const>) 는 이번에 추가된 위젯들로 한 번 호출된다. */
+	template<typename FuncType>
+	TArrayView<T* const> AddToPanelCount(const int InCount, FuncType&& InInitFunc)
+	{
+		const int StartIndex = Lists->ActivatedChildList.Num();
+		Lists->ActivatedChildList.Reserve(StartIndex + InCount);
+
+		for (int Index = 0; Index < InCount; Index++)
+		{
+			AddToPanelNoCount();
+		}
+		UpdateCounts();
+
+		const TArrayView<T* const> OutChildList = GetActivatedChildList().Slice(StartIndex, Lists->ActivatedChildList.Num() - StartIndex);
+		InInitFunc(OutChildList);
+		return OutChildList;
+	}
+
+	TArrayView<T* const> AddToPanelCount(const int InCount)
+	{
+		return AddToPanelCount(InCount, [](TArrayView<T* const>) {});
+	}
+
+	/** Remove from panel */
+	void RemoveAtFromPanel(const int InIndex)
+	{
+		if (Lists->ActivatedChildList.IsValidIndex(InIndex) == false) return;
+
+		UUserWidget* InChild = Lists->ActivatedChildList[InIndex];
+		InChild->RemoveFromParent();
+		Lists->DeActivatedChildList.Emplace(InChild);
+		Lists->ActivatedChildList.RemoveAt(InIndex, 1, false);
+
+		GetStats().Releases++;
+		INC_DWORD_STAT(STAT_WidgetPoolRelease);
+		UpdateCounts();
+		TrimToBudget();
+	}
+
+	void RemoveFromPanel(T* InChild)
+	{
+		RemoveAtFromPanel(Lists->ActivatedChildList.Find(InChild));
+	}
+
+	void RemoveAllFromPanel()
+	{
+		GetStats().Releases += Lists->ActivatedChildList.Num();
+		INC_DWORD_STAT_BY(STAT_WidgetPoolRelease, Lists->ActivatedChildList.Num());
+
+		for (UUserWidget* InChild : Lists->ActivatedChildList)
+		{
+			InChild->RemoveFromParent();
+		}
+
+		Lists->DeActivatedChildList.Append(Lists->ActivatedChildList);
+		Lists->ActivatedChildList.Reset();
+		UpdateCounts();
+		TrimToBudget();
+	}
+
+	/** Clear - 대기 위젯은 공유 풀로 돌려준다. */
+	void Clear()
+	{
+		if (IsValid(Lists->Panel) == false) return;
+
+		Lists->Panel->ClearChildren();
+
+		// 대기 위젯만 (활성 위젯은 호출한 쪽에서 아직 들고 있을 수 있다.)
+		if (UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Lists->Panel))
+		{
+			for (UUserWidget* InChild : Lists->DeActivatedChildList) SharedPool->Return(InChild);
+		}
+
+		Lists->ActivatedChildList.Empty();
+		Lists->DeActivatedChildList.Empty();
+		UpdateCounts();
+	}
+
+	/** Get - 목록의 위젯은 모두 T 로 만든 것이다. */
+	inline TArrayView<T* const> GetActivatedChildList() const
+	{
+		return TArrayView<T* const>(reinterpret_cast<T* const*>(Lists->ActivatedChildList.GetData()), Lists->ActivatedChildList.Num());
+	}
+	inline T* GetActivatedChildAtIndex(const int InIndex) const { return Lists->ActivatedChildList.IsValidIndex(InIndex) ? static_cast<T*>(Lists->ActivatedChildList[InIndex]) : nullptr; }
+
+	template<typename PredType>
+	T* FindActivatedChildByPredicate(PredType&& InPred) const
+	{
+		T* const* FoundWidget = GetActivatedChildList().FindByPredicate(Forward<PredType>(InPred));
+		return FoundWidget != nullptr ? *FoundWidget : nullptr;
+	}
+
+private:
+	T* AddToPanelNoCount()
+	{
+		T* OutChild = GetChild();
+		if (OutChild == nullptr) return nullptr;
+
+		OutChild->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+		Lists->Panel->AddChild(OutChild);
+		Lists->ActivatedChildList.Emplace(OutChild);
+		GetStats().MeasureChild(OutChild);
+		return OutChild;
+	}
+
+	T* CreateNewChild()
+	{
+		if (IsValid(Lists->ChildClass) == false || IsValid(Lists->Panel) == false) return nullptr;
+
+		FWidgetPoolStats& InStats = GetStats();
+		InStats.Misses++;
+		INC_DWORD_STAT(STAT_WidgetPoolMiss);
+
+		SCOPE_CYCLE_COUNTER(STAT_WidgetPoolConstruct);
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		T* NewChild = CreateWidget<T>(Lists->Panel->GetWorld(), Lists->ChildClass);
+		InStats.ConstructCycles += FPlatformTime::Cycles64() - StartCycles;
+
+		return NewChild;
+	}
+
+	/** WidgetPool.BudgetWidgets - 공유 풀을 먼저 비우고, 그래도 넘으면 자기 대기 목록을 버린다. */
+	void TrimToBudget()
+	{
+		UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Lists->Panel);
+		if (SharedPool == nullptr) return;
+
+		while (Lists->DeActivatedChildList.Num() > 0 && SharedPool->EnforceBudget() == false)
+		{
+			Lists->DeActivatedChildList.Pop(false);
+			UpdateCounts();
+		}
+	}
+
+	FWidgetPoolStats& GetStats()
+	{
+		if (Lists->Stats.IsValid() == false)
+		{
+			Lists->Stats = FWidgetPoolStats::Create();
+		}
+
+		return *Lists->Stats;
+	}
+
+	inline void UpdateCounts() { GetStats().UpdateCounts(Lists->ActivatedChildList.Num(), Lists->DeActivatedChildList.Num()); }
+
+private:
+	FWidgetPoolLists* Lists = nullptr;
+};
@@ -0,0 +1,365 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WidgetPoolBenchmark.h"
+#include "BenchmarkHarness.h"
+#include "WidgetPoolContainer.h"
+#include "WidgetPoolStats.h"
+#include "WidgetPoolSubsystem.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/ScrollBox.h"
+#include "Components/VerticalBox.h"
+#include "HAL/PlatformMemory.h"
+#include "Input/HittestGrid.h"
+#include "Layout/ArrangedChildren.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/WidgetStyle.h"
+#include "Tests/AutomationCommon.h"
+#include "Types/PaintArgs.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/SWindow.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWidgetPoolBenchmark, Log, All);
+
+static FAutoConsoleCommandWithWorldAndArgs GWidgetPoolBenchmarkCommand(
+	TEXT("WidgetPool.Benchmark"),
+	TEXT("Run widget pool churn scenarios headless and write per-frame cost as CSV. Usage: WidgetPool.Benchmark [Count=200] [Frames=120] [Refresh=10] [Window=20] [RowExtent=40] [Collapse=0|1] [Shared=0|1] [ChildClass=Path] [Out=File.csv]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		const FBenchmarkArgs Params(Args);
+
+		FWidgetPoolBenchmarkConfig Config;
+		Params.Value(TEXT("Count="), Config.Count);
+		Params.Value(TEXT("Frames="), Config.Frames);
+		Params.Value(TEXT("Refresh="), Config.RefreshCount);
+		Params.Value(TEXT("Window="), Config.WindowCount);
+		Params.Value(TEXT("RowExtent="), Config.RowExtent);
+		Params.Bool(TEXT("Collapse="), Config.bCollapse);
+		Params.Bool(TEXT("Shared="), Config.bSharedPool);
+		Params.Value(TEXT("ChildClass="), Config.ChildClassPath);
+		Params.Value(TEXT("Out="), Config.OutputPath);
+
+		FWidgetPoolBenchmark::Run(World, Config);
+	}));
+
+TSharedRef<SWidget> UWidgetPoolBenchmarkRow::RebuildWidget()
+{
+	return SNew(SBox).HeightOverride(Extent);
+}
+
+namespace WidgetPoolBenchmark
+{
+	enum class EScenario : uint8
+	{
+		BulkFill,
+		PartialRefresh,
+		ClearRefill,
+		ScrollRecycle,
+	};
+
+	static const TCHAR* GetScenarioName(const EScenario InScenario)
+	{
+		switch (InScenario)
+		{
+		case EScenario::BulkFill:		return TEXT("BulkFill");
+		case EScenario::PartialRefresh:	return TEXT("PartialRefresh");
+		case EScenario::ClearRefill:	return TEXT("ClearRefill");
+		case EScenario::ScrollRecycle:	return TEXT("ScrollRecycle");
+		}
+
+		return TEXT("None");
+	}
+
+	struct FFrameSample
+	{
+		double OpMs = 0.0;
+		double PrepassMs = 0.0;
+		double ArrangeMs = 0.0;
+		double PaintMs = 0.0;
+		int64 Constructs = 0;
+		int32 LiveNum = 0;
+		int32 IdleNum = 0;
+	};
+
+	struct FScenarioResult
+	{
+		EScenario Scenario = EScenario::BulkFill;
+		TArray<FFrameSample> Samples;
+		int32 UObjectDelta = 0;
+		double UsedPhysicalMBDelta = 0.0;
+	};
+
+	static void RunScenario(UWorld* InWorld, const FWidgetPoolBenchmarkConfig& InConfig, TSubclassOf<UUserWidget> InChildClass, const EScenario InScenario, FScenarioResult& OutResult)
+	{
+		OutResult.Scenario = InScenario;
+		OutResult.Samples.Reset(InConfig.Frames);
+
+		UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(InWorld);
+		if (SharedPool != nullptr && InConfig.bSharedPool == false)
+		{
+			SharedPool->Empty();
+		}
+
+		const int32 BaseUObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		const uint64 BaseUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+		// 한 번의 호출 안에서 끝나므로 GC 가 돌지 않는다. (스택의 컨테이너도 안전)
+		// ScrollRecycle 은 가상 목록이므로 UScrollBox, 보이는 높이는 WindowCount 행
+		const bool bVirtualList = InScenario == EScenario::ScrollRecycle;
+		UPanelWidget* Panel = nullptr;
+		if (bVirtualList)
+		{
+			Panel = NewObject<UScrollBox>(InWorld);
+		}
+		else
+		{
+			Panel = NewObject<UVerticalBox>(InWorld);
+		}
+		FWidgetPoolContainer Container;
+		Container.InitWidgetPoolContainer<UUserWidget>(Panel, InChildClass);
+		Container.SetCollapseOnRelease(InConfig.bCollapse);
+
+		const TSharedRef<SWidget> SlateWidget = Panel->TakeWidget();
+		const FVector2D RootSize(1920.f, bVirtualList ? InConfig.WindowCount * InConfig.RowExtent : 1080.f);
+		const FGeometry RootGeometry = FGeometry::MakeRoot(RootSize, FSlateLayoutTransform());
+
+		// 가상 목록은 Paint 에서 갱신되는 캐시 지오메트리로 보이는 범위를 정하므로 페인트까지 돌린다.
+		const TSharedRef<SWindow> PaintWindow = SNew(SWindow);
+		FHittestGrid HittestGrid;
+
+		auto LayoutPass = [&](FFrameSample& OutSample)
+		{
+			const double PrepassStartTime = FPlatformTime::Seconds();
+			SlateWidget->SlatePrepass(1.f);
+			OutSample.PrepassMs = (FPlatformTime::Seconds() - PrepassStartTime) * 1000.0;
+
+			const double ArrangeStartTime = FPlatformTime::Seconds();
+			FArrangedChildren ArrangedChildren(EVisibility::Visible);
+			SlateWidget->ArrangeChildren(RootGeometry, ArrangedChildren);
+			OutSample.ArrangeMs = (FPlatformTime::Seconds() - ArrangeStartTime) * 1000.0;
+
+			const double PaintStartTime = FPlatformTime::Seconds();
+			FSlateWindowElementList ElementList(PaintWindow);
+			const FPaintArgs PaintArgs(&PaintWindow.Get(), HittestGrid, FVector2D::ZeroVector, PaintStartTime, 0.f);
+			SlateWidget->Paint(PaintArgs, RootGeometry, FSlateRect(FVector2D::ZeroVector, RootSize), ElementList, 0, FWidgetStyle(), true);
+			OutSample.PaintMs = (FPlatformTime::Seconds() - PaintStartTime) * 1000.0;
+		};
+
+		auto NoBind = [](UUserWidget* InChild, int InItemIndex) {};
+
+		// 처음 목록
+		TArray<int64> Keys;
+		int64 NextKey = 0;
+		if (InScenario == EScenario::PartialRefresh)
+		{
+			for (int32 Index = 0; Index < InConfig.Count; Index++)
+			{
+				Keys.Emplace(NextKey++);
+			}
+			Container.SyncToKeys(Keys, NoBind);
+		}
+		else if (InScenario == EScenario::ClearRefill)
+		{
+			Container.AddToPanelCount(InConfig.Count);
+		}
+		else if (InScenario == EScenario::ScrollRecycle)
+		{
+			// 첫 페인트 전에는 보이는 높이가 0 이므로 한 번 그린 뒤 행 수를 맞춘다.
+			Container.SetVirtualItemSource(InConfig.Count, InConfig.RowExtent, NoBind);
+			FFrameSample WarmupSample;
+			LayoutPass(WarmupSample);
+			Container.UpdateVirtualList();
+		}
+
+		FRandomStream RandomStream(0);
+
+		for (int32 Frame = 0; Frame < InConfig.Frames; Frame++)
+		{
+			FFrameSample& Sample = OutResult.Samples.AddDefaulted_GetRef();
+			const int64 BaseMisses = Container.GetPoolStats() ? Container.GetPoolStats()->Misses : 0;
+
+			const double StartTime = FPlatformTime::Seconds();
+			switch (InScenario)
+			{
+			case EScenario::BulkFill:
+			{
+				Container.Clear();
+				if (SharedPool != nullptr && InConfig.bSharedPool == false)
+				{
+					SharedPool->Empty();
+				}
+				Container.InitWidgetPoolContainer<UUserWidget>(Panel, InChildClass);
+				Container.AddToPanelCount(InConfig.Count);
+				break;
+			}
+			case EScenario::PartialRefresh:
+			{
+				for (int32 Index = 0; Index < InConfig.RefreshCount && Keys.Num() > 0; Index++)
+				{
+					Keys.RemoveAt(RandomStream.RandHelper(Keys.Num()));
+				}
+				for (int32 Index = 0; Index < InConfig.RefreshCount; Index++)
+				{
+					Keys.Insert(NextKey++, RandomStream.RandHelper(Keys.Num() + 1));
+				}
+				Container.SyncToKeys(Keys, NoBind);
+				break;
+			}
+			case EScenario::ClearRefill:
+			{
+				Container.RemoveAllFromPanel();
+				Container.AddToPanelCount(InConfig.Count);
+				break;
+			}
+			case EScenario::ScrollRecycle:
+			{
+				// 한 프레임에 한 행씩 스크롤
+				const int32 FirstIndex = Frame % FMath::Max(InConfig.Count - InConfig.WindowCount, 1);
+				CastChecked<UScrollBox>(Panel)->SetScrollOffset(FirstIndex * InConfig.RowExtent);
+				Container.UpdateVirtualList();
+				break;
+			}
+			}
+			Sample.OpMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			LayoutPass(Sample);
+
+			const FWidgetPoolStats* PoolStats = Container.GetPoolStats();
+			Sample.Constructs = PoolStats ? PoolStats->Misses - BaseMisses : 0;
+			Sample.LiveNum = PoolStats ? PoolStats->LiveNum : 0;
+			Sample.IdleNum = PoolStats ? PoolStats->IdleNum : 0;
+		}
+
+		OutResult.UObjectDelta = GUObjectArray.GetObjectArrayNumMinusAvailable() - BaseUObjects;
+		OutResult.UsedPhysicalMBDelta = (double(FPlatformMemory::GetStats().UsedPhysical) - double(BaseUsedPhysical)) / (1024.0 * 1024.0);
+
+		Container.Clear();
+	}
+}
+
+bool FWidgetPoolBenchmark::Run(UWorld* InWorld, const FWidgetPoolBenchmarkConfig& InConfig, TArray<FWidgetPoolBenchmarkSummary>* OutSummaries)
+{
+	using namespace WidgetPoolBenchmark;
+
+	if (InWorld == nullptr)
+	{
+		return false;
+	}
+
+	FWidgetPoolBenchmarkConfig Config = InConfig;
+	Config.Count = FMath::Max(Config.Count, 1);
+	Config.Frames = FMath::Max(Config.Frames, 1);
+	Config.RefreshCount = FMath::Clamp(Config.RefreshCount, 0, Config.Count);
+	Config.WindowCount = FMath::Clamp(Config.WindowCount, 1, Config.Count);
+	Config.RowExtent = FMath::Max(Config.RowExtent, 1.f);
+
+	TSubclassOf<UUserWidget> ChildClass = UWidgetPoolBenchmarkRow::StaticClass();
+	if (Config.ChildClassPath.IsEmpty() == false)
+	{
+		ChildClass = LoadClass<UUserWidget>(nullptr, *Config.ChildClassPath);
+		if (ChildClass == nullptr || ChildClass->HasAnyClassFlags(CLASS_Abstract))
+		{
+			UE_LOG(LogWidgetPoolBenchmark, Warning, TEXT("Failed to load %s (or the class is abstract)"), *Config.ChildClassPath);
+			return false;
+		}
+	}
+
+	TArray<FScenarioResult> Results;
+	for (const EScenario InScenario : { EScenario::BulkFill, EScenario::PartialRefresh, EScenario::ClearRefill, EScenario::ScrollRecycle })
+	{
+		RunScenario(InWorld, Config, ChildClass, InScenario, Results.AddDefaulted_GetRef());
+	}
+
+	FBenchmarkCsv Csv(TEXT("WidgetPoolBenchmark"), Config.OutputPath, TEXT("Scenario,Frame,OpMs,PrepassMs,ArrangeMs,PaintMs,Constructs,Live,Idle"));
+	for (const FScenarioResult& Result : Results)
+	{
+		for (int32 Frame = 0; Frame < Result.Samples.Num(); Frame++)
+		{
+			const FFrameSample& Sample = Result.Samples[Frame];
+			Csv.AddRow(FString::Printf(TEXT("%s,%d,%.4f,%.4f,%.4f,%.4f,%lld,%d,%d"),
+				GetScenarioName(Result.Scenario), Frame, Sample.OpMs, Sample.PrepassMs, Sample.ArrangeMs, Sample.PaintMs, Sample.Constructs, Sample.LiveNum, Sample.IdleNum));
+		}
+	}
+
+	Csv.AddSummary(FString::Printf(TEXT("ChildClass=%s Count=%d Frames=%d Refresh=%d Window=%d RowExtent=%g Collapse=%d Shared=%d"),
+		*ChildClass->GetName(), Config.Count, Config.Frames, Config.RefreshCount, Config.WindowCount, Config.RowExtent, Config.bCollapse, Config.bSharedPool));
+
+	for (const FScenarioResult& Result : Results)
+	{
+		double OpMsSum = 0.0, OpMsMax = 0.0, PrepassMsSum = 0.0, ArrangeMsSum = 0.0, PaintMsSum = 0.0;
+		int64 Constructs = 0;
+		int32 LiveHighWater = 0;
+		for (const FFrameSample& Sample : Result.Samples)
+		{
+			OpMsSum += Sample.OpMs;
+			OpMsMax = FMath::Max(OpMsMax, Sample.OpMs);
+			PrepassMsSum += Sample.PrepassMs;
+			ArrangeMsSum += Sample.ArrangeMs;
+			PaintMsSum += Sample.PaintMs;
+			Constructs += Sample.Constructs;
+			LiveHighWater = FMath::Max(LiveHighWater, Sample.LiveNum);
+		}
+
+		const int32 NumSamples = FMath::Max(Result.Samples.Num(), 1);
+		Csv.AddSummary(FString::Printf(TEXT("%s OpMsAvg=%.4f OpMsMax=%.4f PrepassMsAvg=%.4f ArrangeMsAvg=%.4f PaintMsAvg=%.4f Constructs=%lld LiveHW=%d UObjectDelta=%d UsedPhysicalMBDelta=%.1f"),
+			GetScenarioName(Result.Scenario), OpMsSum / NumSamples, OpMsMax, PrepassMsSum / NumSamples, ArrangeMsSum / NumSamples, PaintMsSum / NumSamples, Constructs, LiveHighWater, Result.UObjectDelta, Result.UsedPhysicalMBDelta));
+
+		if (OutSummaries != nullptr)
+		{
+			FWidgetPoolBenchmarkSummary& Summary = OutSummaries->AddDefaulted_GetRef();
+			Summary.Scenario = GetScenarioName(Result.Scenario);
+			Summary.OpMsAvg = OpMsSum / NumSamples;
+			Summary.Constructs = Constructs;
+			Summary.LiveHighWater = LiveHighWater;
+		}
+	}
+
+	return Csv.Save();
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWidgetPoolBenchmarkTest, "Project.Benchmark.WidgetPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FWidgetPoolBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// 위젯만 만들므로 게임 월드가 없으면 임시 월드에서 돈다.
+	UWorld* World = AutomationCommon::GetAnyGameWorld();
+	UWorld* TransientWorld = nullptr;
+	if (World == nullptr)
+	{
+		TransientWorld = UWorld::CreateWorld(EWorldType::Game, false);
+		World = TransientWorld;
+	}
+
+	FWidgetPoolBenchmarkConfig Config;
+	Config.Count = 60;
+	Config.Frames = 30;
+	Config.WindowCount = 10;
+	Config.OutputPath = FPaths::AutomationTransientDir() / TEXT("WidgetPoolBenchmark.csv");
+
+	TArray<FWidgetPoolBenchmarkSummary> Summaries;
+	TestTrue(TEXT("Benchmark ran and wrote the CSV"), FWidgetPoolBenchmark::Run(World, Config, &Summaries));
+	TestEqual(TEXT("Scenario count"), Summaries.Num(), 4);
+
+	for (const FWidgetPoolBenchmarkSummary& Summary : Summaries)
+	{
+		TestTrue(FString::Printf(TEXT("%s created widgets"), *Summary.Scenario), Summary.LiveHighWater > 0);
+
+		// 가상 목록은 보이는 행과 앞뒤 여유분만 만든다.
+		if (Summary.Scenario == TEXT("ScrollRecycle"))
+		{
+			TestTrue(TEXT("ScrollRecycle keeps only the visible rows live"), Summary.LiveHighWater < Config.Count);
+		}
+	}
+
+	if (TransientWorld != nullptr)
+	{
+		TransientWorld->DestroyWorld(false);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "WidgetPoolBenchmark.generated.h"
+
+/**
+ * ChildClass 를 지정하지 않았을 때 쓰는 행 위젯. (UUserWidget 은 Abstract 라 CreateWidget 이 실패한다.)
+ * 위젯 트리 없이 고정 높이 박스 하나만 만든다.
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UWidgetPoolBenchmarkRow : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr float Extent = 40.f;
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+};
+
+struct FWidgetPoolBenchmarkConfig
+{
+	/** 목록 크기, 시나리오마다 돌릴 프레임 수 */
+	int32 Count = 200;
+	int32 Frames = 120;
+
+	/** PartialRefresh 에서 프레임마다 바꾸는 항목 수, ScrollRecycle 의 보이는 행 수 */
+	int32 RefreshCount = 10;
+	int32 WindowCount = 20;
+
+	/** ScrollRecycle 의 행 높이. ChildClass 를 지정하면 그 위젯의 높이와 맞춘다. */
+	float RowExtent = UWidgetPoolBenchmarkRow::Extent;
+
+	/** 1 이면 SetCollapseOnRelease(true) */
+	bool bCollapse = false;
+
+	/** 0 이면 시나리오마다 공유 풀을 비워서 재사용 효과를 뺀다. */
+	bool bSharedPool = false;
+
+	/** 비어있으면 UWidgetPoolBenchmarkRow */
+	FString ChildClassPath;
+	FString OutputPath;
+};
+
+/** 시나리오별 요약 (자동화 테스트에서 읽는다.) */
+struct FWidgetPoolBenchmarkSummary
+{
+	FString Scenario;
+	double OpMsAvg = 0.0;
+	int64 Constructs = 0;
+	int32 LiveHighWater = 0;
+};
+
+/**
+ * FWidgetPoolContainer 부하 측정. 실제 화면에서 쓰는 갱신 패턴을 가상 프레임으로 돌리고 CSV 로 남긴다.
+ *   BulkFill      - 빈 컨테이너에 Count 개 추가 (Clear 후 다시)
+ *   PartialRefresh- 프레임마다 RefreshCount 개를 빼고 새로 넣기 (SyncToData)
+ *   ClearRefill   - 프레임마다 RemoveAllFromPanel + AddToPanelCount
+ *   ScrollRecycle - WindowCount 행 높이의 UScrollBox 가상 목록을 프레임마다 한 행씩 스크롤 (SetVirtualItemSource, UpdateVirtualList)
+ * 프레임마다 작업 시간, Slate 프리패스/배치/페인트 시간, 위젯 생성 수를 재고 끝에 UObject, 메모리 증가량을 남긴다.
+ * 페인트는 그리기 요소만 모으고 렌더링은 하지 않으므로 -game -nullrhi 에서 돌릴 수 있다.
+ *
+ * WidgetPool.Benchmark [Count=200] [Frames=120] [Refresh=10] [Window=20] [RowExtent=40] [Collapse=0|1] [Shared=0|1] [ChildClass=/Game/...] [Out=File.csv]
+ * 자동화 테스트: Project.Benchmark.WidgetPool
+ */
+class FWidgetPoolBenchmark
+{
+public:
+	static bool Run(UWorld* InWorld, const FWidgetPoolBenchmarkConfig& InConfig, TArray<FWidgetPoolBenchmarkSummary>* OutSummaries = nullptr);
+};
@@ -2,57 +2,534 @@
 
 
 #include "WidgetPoolContainer.h"
+#include "WidgetPoolSubsystem.h"
+#include "WidgetPoolStats.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+#include "Components/ScrollBox.h"
+#include "Components/Spacer.h"
+
+DECLARE_CYCLE_STAT(TEXT("Prewarm Tick"), STAT_WidgetPoolPrewarmTick, STATGROUP_WidgetPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prewarm Built"), STAT_WidgetPoolPrewarmBuilt, STATGROUP_WidgetPool);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prewarm Hitches Avoided"), STAT_WidgetPoolPrewarmHit, STATGROUP_WidgetPool);
+
+/**
+ * FWidgetPoolContainer::Prewarm 의 시간 분할 생성.
+ * 컨테이너는 값 타입이라 주소가 바뀔 수 있으므로 생성한 위젯은 컨테이너가 꺼내갈 때까지 여기서 들고 있는다.
+ */
+class FWidgetPoolPrewarmer : public FGCObject, public TSharedFromThis<FWidgetPoolPrewarmer>
+{
+public:
+	FWidgetPoolPrewarmer(UPanelWidget* InPanel, TSubclassOf<UUserWidget> InChildClass)
+		: Panel(InPanel)
+		, ChildClass(InChildClass)
+	{
+	}
+
+	virtual ~FWidgetPoolPrewarmer()
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		Collector.AddReferencedObjects(ReadyList);
+		Collector.AddReferencedObject(ChildClass);
+	}
+
+	virtual FString GetReferencerName() const override { return TEXT("FWidgetPoolPrewarmer"); }
+
+	void Start(const int InCount, const float InMsPerFrame, TFunction<void()> InOnComplete)
+	{
+		RemainCount = FMath::Max(RemainCount, InCount);
+		MsPerFrame = InMsPerFrame;
+		if (InOnComplete)
+		{
+			OnCompleteList.Emplace(MoveTemp(InOnComplete));
+		}
+
+		if (TickerHandle.IsValid() == false)
+		{
+			TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FWidgetPoolPrewarmer::Tick));
+		}
+	}
+
+	UUserWidget* Pop()
+	{
+		while (ReadyList.Num() > 0)
+		{
+			UUserWidget* OutChild = ReadyList.Pop();
+			if (IsValid(OutChild))
+			{
+				INC_DWORD_STAT(STAT_WidgetPoolPrewarmHit);
+				return OutChild;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/** 컨테이너에서 바로 생성한 만큼 줄인다. */
+	void Consume(const int InCount) { RemainCount = FMath::Max(RemainCount - InCount, 0); }
+
+	/** 생성을 멈추고 만들어 둔 위젯과 기다리던 콜백을 넘긴다. */
+	void Cancel(TArray<UUserWidget*>& OutReadyList, TArray<TFunction<void()>>& OutOnCompleteList)
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+		RemainCount = 0;
+
+		OutReadyList = MoveTemp(ReadyList);
+		OutOnCompleteList = MoveTemp(OnCompleteList);
+	}
+
+	inline bool IsRunning() const { return TickerHandle.IsValid(); }
+	inline int GetReadyNum() const { return ReadyList.Num(); }
+
+private:
+	bool Tick(float InDeltaTime)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_WidgetPoolPrewarmTick);
+
+		UPanelWidget* InPanel = Panel.Get();
+		if (IsValid(InPanel) == false || IsValid(ChildClass) == false)
+		{
+			RemainCount = 0;
+		}
+
+		const double EndTime = FPlatformTime::Seconds() + MsPerFrame * 0.001;
+		while (RemainCount > 0)
+		{
+			UUserWidget* NewChild = CreateWidget(InPanel->GetWorld(), ChildClass);
+			RemainCount--;
+
+			if (NewChild != nullptr)
+			{
+				ReadyList.Emplace(NewChild);
+				INC_DWORD_STAT(STAT_WidgetPoolPrewarmBuilt);
+			}
+
+			if (FPlatformTime::Seconds() >= EndTime)
+			{
+				break;
+			}
+		}
+
+		if (RemainCount > 0)
+		{
+			return true;
+		}
+
+		// 콜백에서 컨테이너를 지울 수 있으므로 먼저 정리
+		TSharedRef<FWidgetPoolPrewarmer> KeepAlive = AsShared();
+		TickerHandle.Reset();
+
+		TArray<TFunction<void()>> InOnCompleteList = MoveTemp(OnCompleteList);
+		for (TFunction<void()>& InOnComplete : InOnCompleteList)
+		{
+			InOnComplete();
+		}
+
+		return false;
+	}
+
+private:
+	TWeakObjectPtr<UPanelWidget> Panel;
+	UClass* ChildClass = nullptr;
+
+	TArray<UUserWidget*> ReadyList;
+	TArray<TFunction<void()>> OnCompleteList;
+
+	int RemainCount = 0;
+	float MsPerFrame = 0.f;
+
+	FDelegateHandle TickerHandle;
+};
 
 UUserWidget* FWidgetPoolContainer::GetChild()
 {
 	if (DeActivatedChildList.Num() > 0)
 	{
+		GetStats().Reacquires++;
+		INC_DWORD_STAT(STAT_WidgetPoolReacquire);
 		return DeActivatedChildList.Pop();
 	}
-	else
+
+	if (Prewarmer.IsValid())
 	{
-		return CreateNewChild();
+		if (UUserWidget* OutChild = Prewarmer->Pop())
+		{
+			GetStats().PrewarmHits++;
+			return OutChild;
+		}
+
+		// 아직 만들지 못한 경우 바로 생성하고 남은 개수에서 뺀다.
+		Prewarmer->Consume(1);
+	}
+
+	// 다른 화면에서 돌려준 위젯
+	if (UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Panel))
+	{
+		if (UUserWidget* OutChild = SharedPool->Acquire(ChildClass))
+		{
+			GetStats().SharedHits++;
+			INC_DWORD_STAT(STAT_WidgetPoolSharedHit);
+			return OutChild;
+		}
 	}
+
+	return CreateNewChild();
+}
+
+void FWidgetPoolContainer::Prewarm(int InCount, float InMsPerFrame, TFunction<void()> InOnComplete)
+{
+	const int InReadyNum = DeActivatedChildList.Num() + (Prewarmer.IsValid() ? Prewarmer->GetReadyNum() : 0);
+	if (InCount <= InReadyNum || IsValid(ChildClass.Get()) == false || IsValid(Panel) == false)
+	{
+		if (InOnComplete)
+		{
+			InOnComplete();
+		}
+		return;
+	}
+
+	if (Prewarmer.IsValid() == false)
+	{
+		Prewarmer = MakeShared<FWidgetPoolPrewarmer>(Panel, ChildClass);
+	}
+
+	Prewarmer->Start(InCount - InReadyNum, InMsPerFrame, MoveTemp(InOnComplete));
+}
+
+bool FWidgetPoolContainer::IsPrewarming() const
+{
+	return Prewarmer.IsValid() && Prewarmer->IsRunning();
 }
 
 UUserWidget* FWidgetPoolContainer::AddToPanel()
 {
+	// 숨겨둔 위젯은 보이기만 한다.
+	if (CollapsedChildList.Num() > 0)
+	{
+		UUserWidget* OutChild = CollapsedChildList.Pop(false);
+		OutChild->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+		AllocateSlot(OutChild, ActivatedChildList.Emplace(OutChild));
+
+		GetStats().Reacquires++;
+		INC_DWORD_STAT(STAT_WidgetPoolReacquire);
+		UpdateStatCounts();
+		return OutChild;
+	}
+
 	UUserWidget* OutChild = GetChild();
 	if (IsValid(OutChild) == false) return nullptr;
 
 	OutChild->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
 	Panel->AddChild(OutChild);
-	ActivatedChildList.Emplace(OutChild);
+	AllocateSlot(OutChild, ActivatedChildList.Emplace(OutChild));
+	GetStats().MeasureChild(OutChild);
+	UpdateStatCounts();
 	return OutChild;
 }
 
+FWidgetPoolHandle FWidgetPoolContainer::AddToPanelHandle(int64 InKey)
+{
+	if (InKey != INDEX_NONE)
+	{
+		const FWidgetPoolHandle FoundHandle = FindHandleByKey(InKey);
+		if (FoundHandle.IsSet()) return FoundHandle;
+	}
+
+	UUserWidget* OutChild = AddToPanel();
+	if (IsValid(OutChild) == false) return FWidgetPoolHandle();
+
+	// AddToPanel 은 항상 끝에 추가한다.
+	const int32 SlotIndex = ActiveSlotIndices.Last();
+	if (InKey != INDEX_NONE)
+	{
+		Slots[SlotIndex].Key = InKey;
+		KeyToSlot.Emplace(InKey, SlotIndex);
+	}
+
+	FWidgetPoolHandle OutHandle;
+	OutHandle.Index = SlotIndex;
+	OutHandle.Serial = Slots[SlotIndex].Serial;
+	return OutHandle;
+}
+
+UUserWidget* FWidgetPoolContainer::GetChildByHandle(const FWidgetPoolHandle& InHandle) const
+{
+	if (Slots.IsValidIndex(InHandle.Index) == false) return nullptr;
+
+	const FWidgetPoolSlot& InSlot = Slots[InHandle.Index];
+	if (InSlot.Serial != InHandle.Serial || ActivatedChildList.IsValidIndex(InSlot.ActiveIndex) == false) return nullptr;
+
+	return ActivatedChildList[InSlot.ActiveIndex];
+}
+
+UUserWidget* FWidgetPoolContainer::FindChildByKey(int64 InKey) const
+{
+	return GetChildByHandle(FindHandleByKey(InKey));
+}
+
+FWidgetPoolHandle FWidgetPoolContainer::FindHandleByKey(int64 InKey) const
+{
+	FWidgetPoolHandle OutHandle;
+
+	const int32* SlotIndex = KeyToSlot.Find(InKey);
+	if (SlotIndex == nullptr) return OutHandle;
+
+	OutHandle.Index = *SlotIndex;
+	OutHandle.Serial = Slots[*SlotIndex].Serial;
+	return OutHandle;
+}
+
+FWidgetPoolHandle FWidgetPoolContainer::FindHandleByChild(UUserWidget* InChild) const
+{
+	FWidgetPoolHandle OutHandle;
+
+	const int32* SlotIndex = ChildToSlot.Find(InChild);
+	if (SlotIndex == nullptr) return OutHandle;
+
+	OutHandle.Index = *SlotIndex;
+	OutHandle.Serial = Slots[*SlotIndex].Serial;
+	return OutHandle;
+}
+
+void FWidgetPoolContainer::RemoveFromPanelByHandle(const FWidgetPoolHandle& InHandle)
+{
+	if (GetChildByHandle(InHandle) == nullptr) return;
+
+	RemoveAtFromPanel(Slots[InHandle.Index].ActiveIndex);
+}
+
+void FWidgetPoolContainer::RemoveFromPanelByKey(int64 InKey)
+{
+	RemoveFromPanelByHandle(FindHandleByKey(InKey));
+}
+
+void FWidgetPoolContainer::SetVirtualItemSource(int InItemCount, float InItemExtent, TFunction<void(UUserWidget* InChild, int InItemIndex)> InBindFunc, int InOverscan)
+{
+	if (Cast<UScrollBox>(Panel) == nullptr || InItemExtent <= 0.f) return;
+
+	if (VirtualHeadSpacer == nullptr)
+	{
+		RemoveAllFromPanel();
+		ReleaseCollapsedChildren();
+
+		VirtualHeadSpacer = NewObject<USpacer>(Panel);
+		VirtualTailSpacer = NewObject<USpacer>(Panel);
+		Panel->AddChild(VirtualHeadSpacer);
+		Panel->AddChild(VirtualTailSpacer);
+	}
+
+	VirtualItemCount = FMath::Max(InItemCount, 0);
+	VirtualItemExtent = InItemExtent;
+	VirtualOverscan = FMath::Max(InOverscan, 0);
+	VirtualBindFunc = MoveTemp(InBindFunc);
+
+	// 항목이 바뀌었으므로 모두 다시 묶는다.
+	VirtualFirstIndex = INDEX_NONE;
+	UpdateVirtualList();
+}
+
+void FWidgetPoolContainer::UpdateVirtualList()
+{
+	UScrollBox* ScrollBox = Cast<UScrollBox>(Panel);
+	if (IsVirtualList() == false || ScrollBox == nullptr) return;
+
+	const bool bVertical = ScrollBox->Orientation == EOrientation::Orient_Vertical;
+	const FVector2D ViewSize = ScrollBox->GetCachedGeometry().GetLocalSize();
+	const float ViewExtent = bVertical ? ViewSize.Y : ViewSize.X;
+	const float ScrollOffset = ScrollBox->GetScrollOffset();
+
+	const int NewFirstIndex = FMath::Clamp(FMath::FloorToInt(ScrollOffset / VirtualItemExtent) - VirtualOverscan, 0, VirtualItemCount);
+	const int NewLastIndex = FMath::Clamp(FMath::CeilToInt((ScrollOffset + ViewExtent) / VirtualItemExtent) + VirtualOverscan, NewFirstIndex, VirtualItemCount);
+	const int NewRowCount = NewLastIndex - NewFirstIndex;
+
+	if (NewFirstIndex == VirtualFirstIndex && NewRowCount == ActivatedChildList.Num()) return;
+
+	const int PrevFirstIndex = VirtualFirstIndex;
+	const int PrevRowCount = ActivatedChildList.Num();
+
+	// 행 수 맞추기 - 꼬리 스페이서가 항상 마지막에 오도록 다시 붙인다.
+	if (NewRowCount > PrevRowCount)
+	{
+		VirtualTailSpacer->RemoveFromParent();
+		for (int Index = PrevRowCount; Index < NewRowCount; Index++)
+		{
+			if (AddToPanel() == nullptr) break;
+		}
+		Panel->AddChild(VirtualTailSpacer);
+	}
+	else
+	{
+		for (int Index = PrevRowCount - 1; Index >= NewRowCount; Index--)
+		{
+			RemoveAtFromPanel(Index);
+		}
+	}
+
+	VirtualFirstIndex = NewFirstIndex;
+
+	// 행 위치는 고정이므로 항목이 바뀐 행만 다시 묶는다.
+	for (int Index = 0; Index < ActivatedChildList.Num(); Index++)
+	{
+		const bool bSameItem = PrevFirstIndex == NewFirstIndex && Index < PrevRowCount;
+		if (bSameItem == false && VirtualBindFunc)
+		{
+			VirtualBindFunc(ActivatedChildList[Index], NewFirstIndex + Index);
+		}
+	}
+
+	const float HeadExtent = NewFirstIndex * VirtualItemExtent;
+	const float TailExtent = (VirtualItemCount - NewFirstIndex - ActivatedChildList.Num()) * VirtualItemExtent;
+	VirtualHeadSpacer->SetSize(bVertical ? FVector2D(0.f, HeadExtent) : FVector2D(HeadExtent, 0.f));
+	VirtualTailSpacer->SetSize(bVertical ? FVector2D(0.f, TailExtent) : FVector2D(TailExtent, 0.f));
+}
+
+UUserWidget* FWidgetPoolContainer::FindVirtualChild(int InItemIndex)
+{
+	if (IsVirtualList() == false || VirtualFirstIndex == INDEX_NONE) return nullptr;
+
+	return GetActivatedChildAtIndex(InItemIndex - VirtualFirstIndex);
+}
+
+void FWidgetPoolContainer::SyncToKeys(const TArray<int64>& InKeys, TFunctionRef<void(UUserWidget* InChild, int InItemIndex)> InBindFunc)
+{
+	if (IsValid(Panel) == false || IsVirtualList() == true) return;
+
+	// 패널 순서로 비교하므로 숨겨둔 위젯은 떼어내고 떼는 방식으로 처리
+	ReleaseCollapsedChildren();
+	TGuardValue<bool> CollapseGuard(bCollapseOnRelease, false);
+
+	// 새 목록에 없는 위젯만 제거
+	TSet<int64> NewKeySet(InKeys);
+	for (int Index = ActivatedChildList.Num() - 1; Index >= 0; Index--)
+	{
+		const int64 InKey = Slots[ActiveSlotIndices[Index]].Key;
+		if (InKey == INDEX_NONE || NewKeySet.Contains(InKey) == false)
+		{
+			RemoveAtFromPanel(Index);
+		}
+	}
+
+	// 앞에서부터 순서가 같은 만큼은 그대로 둔다.
+	int StableCount = 0;
+	while (StableCount < InKeys.Num() && StableCount < Panel->GetChildrenCount() && Panel->GetChildAt(StableCount) == FindChildByKey(InKeys[StableCount]))
+	{
+		StableCount++;
+	}
+
+	// 나머지는 떼어냈다가 순서대로 한 번에 붙인다. (레이아웃 무효화는 다음 프리패스에서 한 번만 처리됨)
+	for (int Index = Panel->GetChildrenCount() - 1; Index >= StableCount; Index--)
+	{
+		Panel->RemoveChildAt(Index);
+	}
+
+	TArray<UUserWidget*> OrderedChildList;
+	OrderedChildList.Reserve(InKeys.Num());
+	for (int Index = 0; Index < InKeys.Num(); Index++)
+	{
+		UUserWidget* InChild = FindChildByKey(InKeys[Index]);
+		if (Index < StableCount)
+		{
+			OrderedChildList.Emplace(InChild);
+			continue;
+		}
+
+		if (InChild == nullptr)
+		{
+			InChild = GetChildByHandle(AddToPanelHandle(InKeys[Index]));
+			if (InChild == nullptr) continue;
+		}
+		else if (InChild->GetParent() == nullptr)
+		{
+			Panel->AddChild(InChild);
+		}
+		else
+		{
+			// 중복 키
+			continue;
+		}
+
+		OrderedChildList.Emplace(InChild);
+	}
+
+	// ActivatedChildList 도 항목 순서로
+	ActivatedChildList = MoveTemp(OrderedChildList);
+	ActiveSlotIndices.Reset();
+	for (int Index = 0; Index < ActivatedChildList.Num(); Index++)
+	{
+		const int32 SlotIndex = ChildToSlot.FindChecked(ActivatedChildList[Index]);
+		Slots[SlotIndex].ActiveIndex = Index;
+		ActiveSlotIndices.Emplace(SlotIndex);
+	}
+
+	for (int Index = 0, ChildIndex = 0; Index < InKeys.Num() && ChildIndex < ActivatedChildList.Num(); Index++)
+	{
+		if (ActivatedChildList[ChildIndex] == FindChildByKey(InKeys[Index]))
+		{
+			InBindFunc(ActivatedChildList[ChildIndex++], Index);
+		}
+	}
+}
+
 void FWidgetPoolContainer::RemoveAtFromPanel(int InIndex)
 {
 	if (ActivatedChildList.IsValidIndex(InIndex) == false) return;
 
-	ActivatedChildList[InIndex]->RemoveFromParent();
+	UUserWidget* InChild = ActivatedChildList[InIndex];
+	if (bCollapseOnRelease)
+	{
+		InChild->SetVisibility(ESlateVisibility::Collapsed);
+		CollapsedChildList.Emplace(InChild);
+	}
+	else
+	{
+		InChild->RemoveFromParent();
+		DeActivatedChildList.Emplace(InChild);
+	}
+
+	RemoveActivatedAt(InIndex);
 
-	DeActivatedChildList.Emplace(ActivatedChildList[InIndex]);
-	ActivatedChildList.RemoveAt(InIndex);
+	GetStats().Releases++;
+	INC_DWORD_STAT(STAT_WidgetPoolRelease);
+	UpdateStatCounts();
 }
 
 void FWidgetPoolContainer::RemoveFromPanel(UUserWidget* InChild)
 {
-	int Index = ActivatedChildList.Find(InChild);
-	if (Index == INDEX_NONE) return;
+	const int32* SlotIndex = ChildToSlot.Find(InChild);
+	if (SlotIndex == nullptr) return;
 
-	RemoveAtFromPanel(Index);
+	RemoveAtFromPanel(Slots[*SlotIndex].ActiveIndex);
 }
 
 void FWidgetPoolContainer::RemoveAllFromPanel()
 {
-	for (UUserWidget* InChild : ActivatedChildList)
+	GetStats().Releases += ActivatedChildList.Num();
+	INC_DWORD_STAT_BY(STAT_WidgetPoolRelease, ActivatedChildList.Num());
+
+	// 숨겨둔 위젯은 AddToPanel 에서 앞 슬롯부터 다시 쓰도록 뒤에서부터 넣는다.
+	for (int Index = ActivatedChildList.Num() - 1; Index >= 0; Index--)
 	{
-		InChild->RemoveFromParent();
-		DeActivatedChildList.Emplace(InChild);
+		UUserWidget* InChild = ActivatedChildList[Index];
+		if (bCollapseOnRelease)
+		{
+			InChild->SetVisibility(ESlateVisibility::Collapsed);
+			CollapsedChildList.Emplace(InChild);
+		}
+		else
+		{
+			InChild->RemoveFromParent();
+			DeActivatedChildList.Emplace(InChild);
+		}
 	}
 
 	ActivatedChildList.Empty();
+	ResetSlots();
+	UpdateStatCounts();
 }
 
 
@@ -62,8 +539,56 @@ void FWidgetPoolContainer::Clear()
 
 	Panel->ClearChildren();
 
+	// 미리 만든 위젯도 대기 위젯과 같이 돌려준다.
+	TArray<UUserWidget*> PrewarmedChildList;
+	TArray<TFunction<void()>> InOnCompleteList;
+	if (Prewarmer.IsValid())
+	{
+		Prewarmer->Cancel(PrewarmedChildList, InOnCompleteList);
+		Prewarmer.Reset();
+	}
+
+	// 대기 위젯만 공유 풀로 (활성 위젯은 호출한 쪽에서 아직 들고 있을 수 있다.)
+	if (UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Panel))
+	{
+		for (TArray<UUserWidget*>* InChildList : { &DeActivatedChildList, &CollapsedChildList, &PrewarmedChildList })
+		{
+			for (UUserWidget* InChild : *InChildList)
+			{
+				SharedPool->Return(InChild);
+			}
+		}
+	}
+
 	DeActivatedChildList.Empty();
 	ActivatedChildList.Empty();
+	CollapsedChildList.Empty();
+	ResetSlots();
+
+	VirtualHeadSpacer = nullptr;
+	VirtualTailSpacer = nullptr;
+	VirtualBindFunc = nullptr;
+	VirtualItemCount = 0;
+	VirtualItemExtent = 0.f;
+	VirtualFirstIndex = INDEX_NONE;
+
+	UpdateStatCounts();
+
+	// Prewarm 을 기다리던 쪽이 멈추지 않도록 중단된 경우에도 호출한다. (컨테이너를 다 비운 뒤에)
+	for (TFunction<void()>& InOnComplete : InOnCompleteList)
+	{
+		InOnComplete();
+	}
+}
+
+void FWidgetPoolContainer::SetCollapseOnRelease(const bool InValue)
+{
+	bCollapseOnRelease = InValue;
+
+	if (bCollapseOnRelease == false)
+	{
+		ReleaseCollapsedChildren();
+	}
 }
 
 UUserWidget* FWidgetPoolContainer::GetActivatedChildAtIndex(int InIndex)
@@ -73,7 +598,7 @@ UUserWidget* FWidgetPoolContainer::GetActivatedChildAtIndex(int InIndex)
 	return ActivatedChildList[InIndex];
 }
 
-void FWidgetPoolContainer::SetInitFunc(TFunction<void(TArray<UUserWidget*> OutChildList)> InInitFunc)
+void FWidgetPoolContainer::SetInitFunc(const TFunction<void(const TArray<UUserWidget*>& OutChildList)>& InInitFunc)
 {
 	if (InInitFunc)
 	{
@@ -100,8 +625,145 @@ UUserWidget* FWidgetPoolContainer::CreateNewChild()
 	if (IsValid(ChildClass.Get()) == false) return nullptr;
 	if (IsValid(Panel) == false) return nullptr;
 
-	UUserWidget* NewChild = CreateWidget(Panel->GetWorld(), ChildClass);
+	FWidgetPoolStats& InStats = GetStats();
+	InStats.Misses++;
+	INC_DWORD_STAT(STAT_WidgetPoolMiss);
+
+	UUserWidget* NewChild = nullptr;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_WidgetPoolConstruct);
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		NewChild = CreateWidget(Panel->GetWorld(), ChildClass);
+		InStats.ConstructCycles += FPlatformTime::Cycles64() - StartCycles;
+	}
+
 	if (NewChild == nullptr) return nullptr;
 
 	return NewChild;
-}
\ No newline at end of file
+}
+
+FWidgetPoolStats& FWidgetPoolContainer::GetStats()
+{
+	if (Stats.IsValid() == false)
+	{
+		Stats = FWidgetPoolStats::Create();
+	}
+
+	// Init 이후에 클래스, 패널이 정해지는 경우가 있어 매번 갱신
+	Stats->ClassName = ChildClass ? ChildClass->GetFName() : NAME_None;
+	Stats->Panel = Panel;
+	return *Stats;
+}
+
+void FWidgetPoolContainer::UpdateStatCounts()
+{
+	GetStats().UpdateCounts(ActivatedChildList.Num(), DeActivatedChildList.Num() + CollapsedChildList.Num());
+
+	if (DeActivatedChildList.Num() > 0)
+	{
+		TrimToBudget();
+	}
+}
+
+void FWidgetPoolContainer::TrimToBudget()
+{
+	UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(Panel);
+	if (SharedPool == nullptr) return;
+
+	// 공유 풀을 먼저 비우고, 그래도 넘으면 자기 대기 목록을 버린다. (숨겨둔 위젯은 패널에 붙어 있으므로 제외)
+	while (DeActivatedChildList.Num() > 0 && SharedPool->EnforceBudget() == false)
+	{
+		DeActivatedChildList.Pop(false);
+		GetStats().UpdateCounts(ActivatedChildList.Num(), DeActivatedChildList.Num() + CollapsedChildList.Num());
+	}
+}
+
+FWidgetPoolHandle FWidgetPoolContainer::AllocateSlot(UUserWidget* InChild, const int InActiveIndex)
+{
+	const int32 SlotIndex = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : Slots.AddDefaulted();
+
+	FWidgetPoolSlot& InSlot = Slots[SlotIndex];
+	InSlot.ActiveIndex = InActiveIndex;
+	InSlot.Key = INDEX_NONE;
+	ChildToSlot.Emplace(InChild, SlotIndex);
+
+	// InActiveIndex 는 항상 ActivatedChildList 의 끝
+	ActiveSlotIndices.Emplace(SlotIndex);
+
+	FWidgetPoolHandle OutHandle;
+	OutHandle.Index = SlotIndex;
+	OutHandle.Serial = InSlot.Serial;
+	return OutHandle;
+}
+
+void FWidgetPoolContainer::ReleaseSlot(const int32 InSlotIndex)
+{
+	FWidgetPoolSlot& InSlot = Slots[InSlotIndex];
+	if (InSlot.Key != INDEX_NONE)
+	{
+		KeyToSlot.Remove(InSlot.Key);
+	}
+
+	InSlot.ActiveIndex = INDEX_NONE;
+	InSlot.Key = INDEX_NONE;
+	InSlot.Serial++;
+	FreeSlots.Emplace(InSlotIndex);
+}
+
+void FWidgetPoolContainer::ResetSlots()
+{
+	// 남아있는 핸들이 무효가 되도록 Serial 은 유지
+	FreeSlots.Reset();
+	for (int Index = Slots.Num() - 1; Index >= 0; Index--)
+	{
+		if (Slots[Index].ActiveIndex != INDEX_NONE)
+		{
+			Slots[Index].ActiveIndex = INDEX_NONE;
+			Slots[Index].Key = INDEX_NONE;
+			Slots[Index].Serial++;
+		}
+		FreeSlots.Emplace(Index);
+	}
+
+	ChildToSlot.Reset();
+	KeyToSlot.Reset();
+	ActiveSlotIndices.Reset();
+}
+
+void FWidgetPoolContainer::RemoveActivatedAt(const int InIndex)
+{
+	ChildToSlot.Remove(ActivatedChildList[InIndex]);
+	ReleaseSlot(ActiveSlotIndices[InIndex]);
+
+	if (bPreserveOrder)
+	{
+		ActivatedChildList.RemoveAt(InIndex);
+		ActiveSlotIndices.RemoveAt(InIndex);
+
+		for (int Index = InIndex; Index < ActiveSlotIndices.Num(); Index++)
+		{
+			Slots[ActiveSlotIndices[Index]].ActiveIndex = Index;
+		}
+	}
+	else
+	{
+		ActivatedChildList.RemoveAtSwap(InIndex);
+		ActiveSlotIndices.RemoveAtSwap(InIndex);
+
+		if (ActiveSlotIndices.IsValidIndex(InIndex))
+		{
+			Slots[ActiveSlotIndices[InIndex]].ActiveIndex = InIndex;
+		}
+	}
+}
+
+void FWidgetPoolContainer::ReleaseCollapsedChildren()
+{
+	for (UUserWidget* InChild : CollapsedChildList)
+	{
+		InChild->RemoveFromParent();
+		DeActivatedChildList.Emplace(InChild);
+	}
+
+	CollapsedChildList.Empty();
+}
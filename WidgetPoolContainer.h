@@ -5,6 +5,20 @@
 #include "CoreMinimal.h"
 #include "WidgetPoolContainer.generated.h"
 
+class FWidgetPoolPrewarmer;
+struct FWidgetPoolStats;
+class UScrollBox;
+class USpacer;
+
+/** 활성 위젯 핸들. 슬롯이 재사용되어도 Serial 로 구분한다. */
+struct FWidgetPoolHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	inline bool IsSet() const { return Index != INDEX_NONE; }
+	inline bool operator==(const FWidgetPoolHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+};
 
 USTRUCT()
 struct FWidgetPoolContainer
@@ -31,6 +45,14 @@ public:
 	/** Create child */
 	UUserWidget* GetChild();
 
+	/**
+	 * 대기 위젯이 InCount 개가 되도록 프레임마다 InMsPerFrame 만큼만 미리 생성한다. (최소 프레임당 1개)
+	 * 완료 전에 GetChild 가 호출되면 만들어진 것부터 쓰고, 모자라면 기존처럼 바로 생성한다.
+	 * 완료 전에 Clear 되면 만들어진 위젯은 공유 풀로 돌려주고 InOnComplete 는 그 자리에서 호출된다.
+	 */
+	void Prewarm(int InCount, float InMsPerFrame = 2.f, TFunction<void()> InOnComplete = nullptr);
+	bool IsPrewarming() const;
+
 	/** Create child & Add to panel */
 	template<typename T = UUserWidget>
 	T* AddToPanel()
@@ -63,6 +85,62 @@ public:
 		return AddToPanelCount<UUserWidget>(InCount, InInitFunc);
 	}
 
+	/**
+	 * Virtual list - Panel 이 UScrollBox 인 경우만.
+	 * 보이는 행(+ InOverscan)만 위젯을 만들고 나머지는 앞뒤 스페이서로 높이만 채운다.
+	 * 행 위젯의 크기는 InItemExtent 와 같아야 하며, 스크롤하면 행 위젯을 그대로 두고 InBindFunc 로 다른 항목을 다시 묶는다.
+	 */
+	void SetVirtualItemSource(int InItemCount, float InItemExtent, TFunction<void(UUserWidget* InChild, int InItemIndex)> InBindFunc, int InOverscan = 2);
+
+	/** 스크롤, 크기 변경 시 호출 (OnUserScrolled, NativeTick 등) */
+	void UpdateVirtualList();
+
+	/** 항목이 보이는 범위에 있는 경우만 반환 */
+	UUserWidget* FindVirtualChild(int InItemIndex);
+
+	inline bool IsVirtualList() const { return VirtualItemExtent > 0.f; }
+
+	/** Handle - 키(INDEX_NONE 이면 없음)로 다시 찾을 수 있다. 이미 있는 키면 기존 핸들을 반환 */
+	FWidgetPoolHandle AddToPanelHandle(int64 InKey = INDEX_NONE);
+	UUserWidget* GetChildByHandle(const FWidgetPoolHandle& InHandle) const;
+	UUserWidget* FindChildByKey(int64 InKey) const;
+	FWidgetPoolHandle FindHandleByKey(int64 InKey) const;
+	FWidgetPoolHandle FindHandleByChild(UUserWidget* InChild) const;
+	void RemoveFromPanelByHandle(const FWidgetPoolHandle& InHandle);
+	void RemoveFromPanelByKey(int64 InKey);
+
+	/**
+	 * 현재 위젯을 새 목록과 맞춘다. 키가 같은 위젯은 패널에 그대로 두고, 없어진 키만 빼고 새 키만 추가한다.
+	 * 순서가 바뀐 경우 처음 달라진 위치부터만 다시 붙인다. InBindFunc 는 모든 항목에 호출된다.
+	 * InKeyFunc 는 항목마다 다른 int64 를 반환해야 한다. (INDEX_NONE 제외)
+	 */
+	template<typename ItemType, typename KeyFuncType, typename BindFuncType>
+	void SyncToData(const TArray<ItemType>& InItems, KeyFuncType&& InKeyFunc, BindFuncType&& InBindFunc)
+	{
+		TArray<int64> InKeys;
+		InKeys.Reserve(InItems.Num());
+		for (const ItemType& InItem : InItems)
+		{
+			InKeys.Emplace(InKeyFunc(InItem));
+		}
+
+		SyncToKeys(InKeys, [&](UUserWidget* InChild, int InItemIndex) { InBindFunc(InChild, InItems[InItemIndex]); });
+	}
+	void SyncToKeys(const TArray<int64>& InKeys, TFunctionRef<void(UUserWidget* InChild, int InItemIndex)> InBindFunc);
+
+	/**
+	 * true 면 제거한 위젯을 패널에서 떼지 않고 Collapsed 로 두었다가 AddToPanel 에서 그 자리 그대로 다시 보인다.
+	 * 슬롯을 다시 만들지 않고 Visibility 만 바뀌므로 Invalidation Box 안에서도 해당 위젯만 무효화된다.
+	 * 다시 보이는 위치는 원래 슬롯이므로 순서가 중요한 목록은 SyncToData 를 쓴다. (SyncToData 는 떼어내는 방식으로 동작)
+	 */
+	void SetCollapseOnRelease(const bool InValue);
+
+	/**
+	 * false 면 제거시 마지막 위젯을 빈 자리로 옮긴다. (O(1), ActivatedChildList 순서가 바뀜)
+	 * 패널에 보이는 순서와는 무관하다.
+	 */
+	inline void SetPreserveOrder(const bool InValue) { bPreserveOrder = InValue; }
+
 	/** Remove from panel */
 	void RemoveAtFromPanel(int InIndex);
 	void RemoveFromPanel(UUserWidget* InChild);
@@ -72,10 +150,14 @@ public:
 	void Clear();
 
 	/** Get, Set */
-	inline TArray<UUserWidget*>& GetActivatedChildList() { return ActivatedChildList; }
+	/** 핸들 슬롯과 맞춰야 하므로 목록 변경은 AddToPanel, RemoveFromPanel 등으로만 */
+	inline const TArray<UUserWidget*>& GetActivatedChildList() const { return ActivatedChildList; }
 	UUserWidget* GetActivatedChildAtIndex(int InIndex);
 
-	void SetInitFunc(TFunction<void(TArray<UUserWidget*> OutChildList)> InInitFunc);
+	/** 아직 아무것도 만들지 않았으면 nullptr */
+	inline const FWidgetPoolStats* GetPoolStats() const { return Stats.Get(); }
+
+	void SetInitFunc(const TFunction<void(const TArray<UUserWidget*>& OutChildList)>& InInitFunc);
 
 public:
 	UUserWidget* FindActivatedChildByPredicate(TFunction<UUserWidget*(UUserWidget* ActivatedChild)> InPred);
@@ -83,6 +165,19 @@ public:
 private:
 	UUserWidget* CreateNewChild();
 
+	FWidgetPoolHandle AllocateSlot(UUserWidget* InChild, const int InActiveIndex);
+	void ReleaseSlot(const int32 InSlotIndex);
+	void ResetSlots();
+	void RemoveActivatedAt(const int InIndex);
+	void ReleaseCollapsedChildren();
+
+	/** WidgetPool.Dump, STATGROUP_WidgetPool */
+	FWidgetPoolStats& GetStats();
+	void UpdateStatCounts();
+
+	/** WidgetPool.BudgetWidgets */
+	void TrimToBudget();
+
 private:
 	UPROPERTY()
 	UPanelWidget* Panel = nullptr;
@@ -96,5 +191,47 @@ private:
 	UPROPERTY()
 	TArray<UUserWidget*> DeActivatedChildList;
 
-	TFunction<void(TArray<UUserWidget*> OutChildList)> InitFunc;
+	/** bCollapseOnRelease 인 경우 패널에 붙은 채로 숨겨둔 위젯 */
+	UPROPERTY()
+	TArray<UUserWidget*> CollapsedChildList;
+
+	TFunction<void(const TArray<UUserWidget*>& OutChildList)> InitFunc;
+
+	/** Handle */
+	struct FWidgetPoolSlot
+	{
+		int ActiveIndex = INDEX_NONE;
+		uint32 Serial = 0;
+		int64 Key = INDEX_NONE;
+	};
+
+	TArray<FWidgetPoolSlot> Slots;
+	TArray<int32> FreeSlots;
+
+	/** ActivatedChildList 와 같은 순서의 슬롯 번호 (제거 후 ActiveIndex 를 다시 맞출 때 ChildToSlot 을 찾지 않도록) */
+	TArray<int32> ActiveSlotIndices;
+	TMap<UUserWidget*, int32> ChildToSlot;
+	TMap<int64, int32> KeyToSlot;
+
+	bool bPreserveOrder = true;
+	bool bCollapseOnRelease = false;
+
+	/** Virtual list */
+	UPROPERTY()
+	USpacer* VirtualHeadSpacer = nullptr;
+
+	UPROPERTY()
+	USpacer* VirtualTailSpacer = nullptr;
+
+	TFunction<void(UUserWidget* InChild, int InItemIndex)> VirtualBindFunc;
+
+	int VirtualItemCount = 0;
+	float VirtualItemExtent = 0.f;
+	int VirtualOverscan = 0;
+	int VirtualFirstIndex = INDEX_NONE;
+
+	TSharedPtr<FWidgetPoolStats> Stats;
+
+	/** Prewarm 진행 중인 경우만 유효 (생성된 위젯은 여기서 GC 참조) */
+	TSharedPtr<FWidgetPoolPrewarmer> Prewarmer;
 };
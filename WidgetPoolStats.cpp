@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WidgetPoolStats.h"
+#include "WidgetPoolSubsystem.h"
+#include "Components/PanelWidget.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+
+DEFINE_STAT(STAT_WidgetPoolConstruct);
+DEFINE_STAT(STAT_WidgetPoolReacquire);
+DEFINE_STAT(STAT_WidgetPoolSharedHit);
+DEFINE_STAT(STAT_WidgetPoolMiss);
+DEFINE_STAT(STAT_WidgetPoolRelease);
+
+DEFINE_LOG_CATEGORY_STATIC(LogWidgetPool, Log, All);
+
+static TArray<TWeakPtr<FWidgetPoolStats>> GWidgetPoolStatsList;
+static TMap<FName, FWidgetPoolClassStats> GWidgetPoolClassStats;
+static double GWidgetPoolStatsStartTime = 0.0;
+static int64 GWidgetPoolIdleWidgetNum = 0;
+
+static FAutoConsoleCommandWithWorldAndArgs GWidgetPoolDumpCommand(
+	TEXT("WidgetPool.Dump"),
+	TEXT("Log pool hits/misses, reacquire/release rates, construction time and live/idle high-water marks for every widget pool container and class. Usage: WidgetPool.Dump [Reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		struct FClassTotal
+		{
+			int32 Containers = 0;
+			int64 Reacquires = 0;
+			int64 Hits = 0;
+			int64 Misses = 0;
+			int64 Releases = 0;
+			double ConstructMs = 0.0;
+		};
+
+		TMap<FName, FClassTotal> ClassTotals;
+
+		const double ElapsedSeconds = FMath::Max(FWidgetPoolStats::GetElapsedSeconds(), KINDA_SMALL_NUMBER);
+		UE_LOG(LogWidgetPool, Log, TEXT("---- %.1f s since start or last reset"), ElapsedSeconds);
+
+		UE_LOG(LogWidgetPool, Log, TEXT("---- Containers (Owner / Class: Live, Idle, LiveHW, IdleHW, Reacquire/s, Prewarm, Shared, Miss, Release/s, ConstructMs)"));
+		FWidgetPoolStats::ForEach([&ClassTotals, ElapsedSeconds](FWidgetPoolStats& InStats)
+		{
+			UPanelWidget* InPanel = InStats.Panel.Get();
+			UUserWidget* InOwner = InPanel ? InPanel->GetTypedOuter<UUserWidget>() : nullptr;
+			const FString OwnerName = InOwner ? InOwner->GetClass()->GetName() : (InPanel ? InPanel->GetName() : TEXT("None"));
+
+			UE_LOG(LogWidgetPool, Log, TEXT("%s / %s: %d, %d, %d, %d, %.2f, %lld, %lld, %lld, %.2f, %.2f"),
+				*OwnerName, *InStats.ClassName.ToString(), InStats.LiveNum, InStats.IdleNum, InStats.LiveHighWater, InStats.IdleHighWater,
+				InStats.Reacquires / ElapsedSeconds, InStats.PrewarmHits, InStats.SharedHits, InStats.Misses, InStats.Releases / ElapsedSeconds, InStats.GetConstructMs());
+
+			FClassTotal& Total = ClassTotals.FindOrAdd(InStats.ClassName);
+			Total.Containers++;
+			Total.Reacquires += InStats.Reacquires;
+			Total.Hits += InStats.GetHits();
+			Total.Misses += InStats.Misses;
+			Total.Releases += InStats.Releases;
+			Total.ConstructMs += InStats.GetConstructMs();
+		});
+
+		// Live, Idle 과 최고치는 컨테이너 값을 더하지 않고 갱신할 때마다 모은 클래스 합계를 쓴다.
+		UE_LOG(LogWidgetPool, Log, TEXT("---- Classes (Class: Containers, Live, Idle, LiveHW, IdleHW, HitRate, Miss, Reacquire/s, Release/s, ConstructMs)"));
+		for (const TPair<FName, FWidgetPoolClassStats>& Pair : FWidgetPoolStats::GetClassStats())
+		{
+			const FWidgetPoolClassStats& ClassStats = Pair.Value;
+			const FClassTotal Total = ClassTotals.FindRef(Pair.Key);
+			const double HitRate = Total.Hits + Total.Misses > 0 ? double(Total.Hits) / double(Total.Hits + Total.Misses) : 0.0;
+			UE_LOG(LogWidgetPool, Log, TEXT("%s: %d, %d, %d, %d, %d, %.1f%%, %lld, %.2f, %.2f, %.2f"),
+				*Pair.Key.ToString(), Total.Containers, ClassStats.LiveNum, ClassStats.IdleNum, ClassStats.LiveHighWater, ClassStats.IdleHighWater,
+				HitRate * 100.0, Total.Misses, Total.Reacquires / ElapsedSeconds, Total.Releases / ElapsedSeconds, Total.ConstructMs);
+		}
+
+		if (UWidgetPoolSubsystem* SharedPool = UWidgetPoolSubsystem::Get(World))
+		{
+			UE_LOG(LogWidgetPool, Log, TEXT("---- Shared pool: %d idle, %lld UWidgets (containers %lld UWidgets)"),
+				SharedPool->GetTotalIdleNum(), SharedPool->GetTotalWidgetNum(), FWidgetPoolStats::GetTotalIdleWidgetNum());
+		}
+
+		if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+		{
+			FWidgetPoolStats::ResetAll();
+		}
+	}));
+
+FWidgetPoolStats::~FWidgetPoolStats()
+{
+	ApplyToClassStats(-1);
+}
+
+void FWidgetPoolStats::UpdateCounts(const int32 InLiveNum, const int32 InIdleNum)
+{
+	ApplyToClassStats(-1);
+
+	LiveNum = InLiveNum;
+	IdleNum = InIdleNum;
+	LiveHighWater = FMath::Max(LiveHighWater, InLiveNum);
+	IdleHighWater = FMath::Max(IdleHighWater, InIdleNum);
+
+	// ChildClass 가 바뀐 경우 이전 클래스에서 빠지고 새 클래스로 더해진다.
+	CountedClassName = ClassName;
+	CountedIdleWidgetNum = int64(InIdleNum) * FMath::Max(WidgetsPerChild, 1);
+	ApplyToClassStats(1);
+}
+
+void FWidgetPoolStats::ApplyToClassStats(const int32 InSign)
+{
+	if (CountedClassName.IsNone())
+	{
+		return;
+	}
+
+	FWidgetPoolClassStats& ClassStats = GWidgetPoolClassStats.FindOrAdd(CountedClassName);
+	ClassStats.LiveNum += InSign * LiveNum;
+	ClassStats.IdleNum += InSign * IdleNum;
+	ClassStats.LiveHighWater = FMath::Max(ClassStats.LiveHighWater, ClassStats.LiveNum);
+	ClassStats.IdleHighWater = FMath::Max(ClassStats.IdleHighWater, ClassStats.IdleNum);
+
+	GWidgetPoolIdleWidgetNum += InSign * CountedIdleWidgetNum;
+}
+
+void FWidgetPoolStats::MeasureChild(UUserWidget* InChild)
+{
+	if (WidgetsPerChild == 0 && IsValid(InChild))
+	{
+		WidgetsPerChild = CountWidgets(InChild);
+	}
+}
+
+void FWidgetPoolStats::Reset()
+{
+	LiveHighWater = LiveNum;
+	IdleHighWater = IdleNum;
+	Reacquires = 0;
+	PrewarmHits = 0;
+	SharedHits = 0;
+	Misses = 0;
+	Releases = 0;
+	ConstructCycles = 0;
+}
+
+TSharedRef<FWidgetPoolStats> FWidgetPoolStats::Create()
+{
+	TSharedRef<FWidgetPoolStats> OutStats = MakeShared<FWidgetPoolStats>();
+
+	// 생성할 때 정리해서 목록이 계속 커지지 않도록
+	GWidgetPoolStatsList.RemoveAllSwap([](const TWeakPtr<FWidgetPoolStats>& InStats) { return InStats.IsValid() == false; });
+	GWidgetPoolStatsList.Emplace(OutStats);
+
+	if (GWidgetPoolStatsStartTime == 0.0)
+	{
+		GWidgetPoolStatsStartTime = FPlatformTime::Seconds();
+	}
+
+	return OutStats;
+}
+
+void FWidgetPoolStats::ForEach(TFunctionRef<void(FWidgetPoolStats& InStats)> InFunc)
+{
+	for (const TWeakPtr<FWidgetPoolStats>& InWeakStats : GWidgetPoolStatsList)
+	{
+		if (TSharedPtr<FWidgetPoolStats> InStats = InWeakStats.Pin())
+		{
+			InFunc(*InStats);
+		}
+	}
+}
+
+const TMap<FName, FWidgetPoolClassStats>& FWidgetPoolStats::GetClassStats()
+{
+	return GWidgetPoolClassStats;
+}
+
+int64 FWidgetPoolStats::GetTotalIdleWidgetNum()
+{
+	return GWidgetPoolIdleWidgetNum;
+}
+
+int32 FWidgetPoolStats::CountWidgets(UUserWidget* InChild)
+{
+	int32 OutNum = 1;
+	if (InChild->WidgetTree != nullptr)
+	{
+		InChild->WidgetTree->ForEachWidget([&OutNum](UWidget* InWidget)
+		{
+			OutNum++;
+		});
+	}
+
+	return OutNum;
+}
+
+double FWidgetPoolStats::GetElapsedSeconds()
+{
+	return GWidgetPoolStatsStartTime > 0.0 ? FPlatformTime::Seconds() - GWidgetPoolStatsStartTime : 0.0;
+}
+
+void FWidgetPoolStats::ResetAll()
+{
+	ForEach([](FWidgetPoolStats& InStats) { InStats.Reset(); });
+
+	for (TPair<FName, FWidgetPoolClassStats>& Pair : GWidgetPoolClassStats)
+	{
+		Pair.Value.LiveHighWater = Pair.Value.LiveNum;
+		Pair.Value.IdleHighWater = Pair.Value.IdleNum;
+	}
+
+	GWidgetPoolStatsStartTime = FPlatformTime::Seconds();
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+class UPanelWidget;
+class UUserWidget;
+
+DECLARE_STATS_GROUP(TEXT("WidgetPool"), STATGROUP_WidgetPool, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Construct Widget"), STAT_WidgetPoolConstruct, STATGROUP_WidgetPool, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit (Reacquire)"), STAT_WidgetPoolReacquire, STATGROUP_WidgetPool, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit (Shared Pool)"), STAT_WidgetPoolSharedHit, STATGROUP_WidgetPool, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Miss (CreateNewChild)"), STAT_WidgetPoolMiss, STATGROUP_WidgetPool, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Release"), STAT_WidgetPoolRelease, STATGROUP_WidgetPool, );
+
+/** 클래스별 합계. 컨테이너 값이 바뀔 때마다 갱신해서 최고치가 같은 시점의 합이 되도록 한다. */
+struct FWidgetPoolClassStats
+{
+	int32 LiveNum = 0;
+	int32 IdleNum = 0;
+	int32 LiveHighWater = 0;
+	int32 IdleHighWater = 0;
+};
+
+/**
+ * 컨테이너 하나의 누적값. 컨테이너는 값 타입이라 주소가 바뀌므로 TSharedPtr 로 들고 있고, WidgetPool.Dump 는 약한 참조로 모은다.
+ */
+struct FWidgetPoolStats
+{
+	FName ClassName;
+	TWeakObjectPtr<UPanelWidget> Panel;
+
+	int32 LiveNum = 0;
+	int32 IdleNum = 0;
+	int32 LiveHighWater = 0;
+	int32 IdleHighWater = 0;
+
+	int64 Reacquires = 0;		// 자기 대기 목록에서 (Collapsed 포함)
+	int64 PrewarmHits = 0;
+	int64 SharedHits = 0;
+	int64 Misses = 0;			// CreateNewChild
+	int64 Releases = 0;
+
+	uint64 ConstructCycles = 0;
+
+	/** 위젯 하나의 UWidget 개수 (WidgetTree 포함). 0 이면 아직 재지 않음 */
+	int32 WidgetsPerChild = 0;
+
+	inline int64 GetHits() const { return Reacquires + PrewarmHits + SharedHits; }
+	inline double GetConstructMs() const { return FPlatformTime::ToMilliseconds64(ConstructCycles); }
+
+	~FWidgetPoolStats();
+
+	void UpdateCounts(const int32 InLiveNum, const int32 InIdleNum);
+	void Reset();
+
+	/** 처음 한 번만 센다. */
+	void MeasureChild(UUserWidget* InChild);
+
+	static TSharedRef<FWidgetPoolStats> Create();
+
+	/** 살아있는 컨테이너 */
+	static void ForEach(TFunctionRef<void(FWidgetPoolStats& InStats)> InFunc);
+
+	static const TMap<FName, FWidgetPoolClassStats>& GetClassStats();
+
+	/** 살아있는 컨테이너의 대기 위젯(Collapsed 포함)이 가진 UWidget 개수. 공유 풀 예산에 함께 센다. */
+	static int64 GetTotalIdleWidgetNum();
+
+	/** InChild 와 WidgetTree 안의 UWidget 개수 */
+	static int32 CountWidgets(UUserWidget* InChild);
+
+	/** 누적 시작(또는 마지막 Reset) 후 지난 시간 */
+	static double GetElapsedSeconds();
+
+	/** 모든 컨테이너와 클래스 합계 */
+	static void ResetAll();
+
+private:
+	/** 클래스 합계에 반영된 값 */
+	void ApplyToClassStats(const int32 InSign);
+
+	FName CountedClassName;
+	int64 CountedIdleWidgetNum = 0;
+};
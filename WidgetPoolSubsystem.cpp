@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WidgetPoolSubsystem.h"
+#include "WidgetPoolStats.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/GameInstance.h"
+
+static TAutoConsoleVariable<int32> CVarWidgetPoolMaxPerClass(
+	TEXT("WidgetPool.MaxPerClass"),
+	32,
+	TEXT("Max idle widgets kept per widget class in the shared pool."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWidgetPoolBudgetWidgets(
+	TEXT("WidgetPool.BudgetWidgets"),
+	4096,
+	TEXT("Max UWidgets (each idle user widget plus its widget tree) kept idle across the shared pool and every pool container."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWidgetPoolIdleSeconds(
+	TEXT("WidgetPool.IdleSeconds"),
+	60.f,
+	TEXT("Idle widgets older than this are released from the shared pool. 0: never."),
+	ECVF_Default);
+
+void UWidgetPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	OnWorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UWidgetPoolSubsystem::OnWorldCleanup);
+}
+
+void UWidgetPoolSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(OnWorldCleanupHandle);
+	Empty();
+
+	Super::Deinitialize();
+}
+
+void UWidgetPoolSubsystem::Tick(float DeltaTime)
+{
+	// 매 프레임 볼 필요는 없다.
+	TrimAccumulator += DeltaTime;
+	if (TrimAccumulator < 1.f)
+	{
+		return;
+	}
+
+	TrimAccumulator = 0.f;
+	Trim(CVarWidgetPoolIdleSeconds.GetValueOnGameThread());
+}
+
+UWorld* UWidgetPoolSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetGameInstance() ? GetGameInstance()->GetWorld() : nullptr;
+}
+
+UWidgetPoolSubsystem* UWidgetPoolSubsystem::Get(const UObject* InWorldContext)
+{
+	UWorld* InWorld = InWorldContext ? InWorldContext->GetWorld() : nullptr;
+	UGameInstance* InGameInstance = InWorld ? InWorld->GetGameInstance() : nullptr;
+
+	return InGameInstance ? InGameInstance->GetSubsystem<UWidgetPoolSubsystem>() : nullptr;
+}
+
+UUserWidget* UWidgetPoolSubsystem::Acquire(TSubclassOf<UUserWidget> InChildClass)
+{
+	FWidgetPoolClassEntry* InEntry = ClassEntries.Find(InChildClass);
+	if (InEntry == nullptr)
+	{
+		return nullptr;
+	}
+
+	// 가장 최근에 반납된 것부터 (캐시에 남아 있을 가능성이 높음)
+	while (InEntry->IdleList.Num() > 0)
+	{
+		UUserWidget* OutChild = InEntry->IdleList.Last();
+		RemoveIdleAt(*InEntry, InEntry->IdleList.Num() - 1);
+
+		if (IsValid(OutChild))
+		{
+			return OutChild;
+		}
+	}
+
+	return nullptr;
+}
+
+void UWidgetPoolSubsystem::Return(UUserWidget* InChild)
+{
+	if (IsValid(InChild) == false || InChild->GetParent() != nullptr)
+	{
+		return;
+	}
+
+	FWidgetPoolClassEntry& InEntry = ClassEntries.FindOrAdd(InChild->GetClass());
+	if (InEntry.WidgetNum == 0)
+	{
+		InEntry.WidgetNum = FWidgetPoolStats::CountWidgets(InChild);
+	}
+
+	InEntry.IdleList.Emplace(InChild);
+	InEntry.ReturnTimes.Emplace(FPlatformTime::Seconds());
+	TotalIdleNum++;
+	TotalWidgetNum += InEntry.WidgetNum;
+
+	// 클래스별 한도
+	const int32 MaxPerClass = FMath::Max(CVarWidgetPoolMaxPerClass.GetValueOnGameThread(), 0);
+	while (InEntry.IdleList.Num() > MaxPerClass)
+	{
+		RemoveIdleAt(InEntry, 0);
+	}
+
+	// 전체 예산
+	EnforceBudget();
+}
+
+void UWidgetPoolSubsystem::Trim(const double InMaxIdleSeconds)
+{
+	if (InMaxIdleSeconds > 0.0)
+	{
+		const double ExpireTime = FPlatformTime::Seconds() - InMaxIdleSeconds;
+		for (TPair<TSubclassOf<UUserWidget>, FWidgetPoolClassEntry>& Pair : ClassEntries)
+		{
+			while (Pair.Value.ReturnTimes.Num() > 0 && Pair.Value.ReturnTimes[0] < ExpireTime)
+			{
+				RemoveIdleAt(Pair.Value, 0);
+			}
+		}
+	}
+
+	// cvar 가 줄어든 경우
+	EnforceBudget();
+}
+
+void UWidgetPoolSubsystem::Empty()
+{
+	ClassEntries.Empty();
+	TotalIdleNum = 0;
+	TotalWidgetNum = 0;
+}
+
+bool UWidgetPoolSubsystem::EnforceBudget()
+{
+	const int64 BudgetNum = FMath::Max(CVarWidgetPoolBudgetWidgets.GetValueOnGameThread(), 0);
+	while (TotalWidgetNum + FWidgetPoolStats::GetTotalIdleWidgetNum() > BudgetNum)
+	{
+		if (RemoveOldest() == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UWidgetPoolSubsystem::OnWorldCleanup(UWorld* InWorld, bool bInSessionEnded, bool bInCleanupResources)
+{
+	// 월드를 Outer 로 만든 위젯이 월드를 붙잡지 않도록
+	for (TPair<TSubclassOf<UUserWidget>, FWidgetPoolClassEntry>& Pair : ClassEntries)
+	{
+		for (int32 Index = Pair.Value.IdleList.Num() - 1; Index >= 0; Index--)
+		{
+			UUserWidget* InChild = Pair.Value.IdleList[Index];
+			if (IsValid(InChild) == false || InChild->IsIn(InWorld) == true)
+			{
+				RemoveIdleAt(Pair.Value, Index);
+			}
+		}
+	}
+}
+
+void UWidgetPoolSubsystem::RemoveIdleAt(FWidgetPoolClassEntry& InOutEntry, const int32 InIndex)
+{
+	InOutEntry.IdleList.RemoveAt(InIndex);
+	InOutEntry.ReturnTimes.RemoveAt(InIndex);
+	TotalIdleNum--;
+	TotalWidgetNum -= InOutEntry.WidgetNum;
+}
+
+bool UWidgetPoolSubsystem::RemoveOldest()
+{
+	FWidgetPoolClassEntry* OldestEntry = nullptr;
+	for (TPair<TSubclassOf<UUserWidget>, FWidgetPoolClassEntry>& Pair : ClassEntries)
+	{
+		if (Pair.Value.ReturnTimes.Num() > 0 && (OldestEntry == nullptr || Pair.Value.ReturnTimes[0] < OldestEntry->ReturnTimes[0]))
+		{
+			OldestEntry = &Pair.Value;
+		}
+	}
+
+	if (OldestEntry == nullptr)
+	{
+		return false;
+	}
+
+	RemoveIdleAt(*OldestEntry, 0);
+	return true;
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "WidgetPoolSubsystem.generated.h"
+
+class UUserWidget;
+
+USTRUCT()
+struct FWidgetPoolClassEntry
+{
+	GENERATED_BODY()
+
+public:
+	/** 오래된 것부터 (0 이 가장 오래 쉰 위젯) */
+	UPROPERTY()
+	TArray<UUserWidget*> IdleList;
+
+	TArray<double> ReturnTimes;
+
+	/** 위젯 하나의 UWidget 개수 (WidgetTree 포함, 처음 반납될 때 한 번 계산) */
+	int32 WidgetNum = 0;
+};
+
+/**
+ * 게임 인스턴스 단위로 ChildClass 별 대기 위젯을 공유한다.
+ * FWidgetPoolContainer 는 자기 대기 목록이 비면 여기서 빌려가고, Clear 될 때 대기 위젯을 돌려준다.
+ * 사용 중에는 대기 위젯을 그대로 들고 있으므로 전체 갱신(RemoveAllFromPanel + AddToPanelCount)에서 다시 생성하지 않는다.
+ * 클래스별 최대 개수, 전체 UWidget 개수 예산을 넘으면 가장 오래 쉰 위젯부터 버린다. (WidgetPool.* 참고)
+ * 예산에는 컨테이너가 들고 있는 대기 위젯도 포함되며, 공유 풀을 다 비워도 넘으면 컨테이너가 자기 대기 목록을 줄인다.
+ */
+UCLASS()
+class UWidgetPoolSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return IsTemplate() == false && TotalIdleNum > 0; }
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UWidgetPoolSubsystem, STATGROUP_Tickables); }
+
+	static UWidgetPoolSubsystem* Get(const UObject* InWorldContext);
+
+	/** 없으면 nullptr (새로 만들지 않음) */
+	UUserWidget* Acquire(TSubclassOf<UUserWidget> InChildClass);
+
+	/** 패널에서 뗀 위젯만 */
+	void Return(UUserWidget* InChild);
+
+	/** InMaxIdleSeconds 보다 오래 쉰 위젯, 한도를 넘는 위젯을 버린다. */
+	void Trim(const double InMaxIdleSeconds);
+	void Empty();
+
+	/** 예산을 넘으면 공유 풀의 오래된 위젯부터 버린다. 다 버려도 넘으면 false */
+	bool EnforceBudget();
+
+	inline int32 GetTotalIdleNum() const { return TotalIdleNum; }
+	inline int64 GetTotalWidgetNum() const { return TotalWidgetNum; }
+
+private:
+	void OnWorldCleanup(UWorld* InWorld, bool bInSessionEnded, bool bInCleanupResources);
+
+	void RemoveIdleAt(FWidgetPoolClassEntry& InOutEntry, const int32 InIndex);
+	bool RemoveOldest();
+
+private:
+	UPROPERTY()
+	TMap<TSubclassOf<UUserWidget>, FWidgetPoolClassEntry> ClassEntries;
+
+	int32 TotalIdleNum = 0;
+	int64 TotalWidgetNum = 0;
+
+	float TrimAccumulator = 0.f;
+
+	FDelegateHandle OnWorldCleanupHandle;
+};